@@ -0,0 +1,524 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "lite.h"
+#include "lite_multimatch.h"
+#include "lite_par.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Stores results here so that the compiler cannot throw the benchmarked code away.
+static volatile size_t sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0) {
+        perror("clock_gettime");
+        abort();
+    }
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double start_ns, size_t nops, const char *op)
+{
+    double elapsed = now_ns() - start_ns;
+    fprintf(stderr, "%-48s %10.2f ns/%s\n", name, elapsed / nops, op);
+}
+
+static void *xmalloc(size_t n)
+{
+    void *p = malloc(n);
+    if (!p) {
+        perror("malloc");
+        abort();
+    }
+    return p;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static const char *log_lines[] = {
+    "2021-03-01 12:00:01 INFO  request served in 12 ms",
+    "2021-03-01 12:00:01 DEBUG cache hit for key user:1234",
+    "2021-03-01 12:00:02 INFO  GET /index.html 200",
+    "2021-03-01 12:00:02 WARN  slow query (250 ms)",
+    "2021-03-01 12:00:03 INFO  connection from 10.0.0.7 accepted",
+    "2021-03-01 12:00:03 ERROR upstream timed out",
+    "2021-03-01 12:00:04 INFO  GET /favicon.ico 404",
+    "2021-03-01 12:00:04 DEBUG worker 3 idle",
+};
+#define NLOG_LINES (sizeof(log_lines) / sizeof(log_lines[0]))
+
+static const char *filter_needles[] = {
+    "panic", "fatal", "segfault", "oom-killer", "corrupt", "deadlock", "assertion", "abort",
+    "refused", "unreachable", "reset by peer", "broken pipe", "timed out", "EAGAIN", "EINTR",
+    "ENOMEM", "ENOSPC", "EACCES", "EPERM", "denied", "invalid token", "expired", "revoked",
+    "checksum", "mismatch", "overflow", "underflow", "truncated", "malformed", "unexpected EOF",
+    "retrying", "giving up", "fallback", "degraded", "throttled", "rate limit", "quota",
+    "backpressure", "stalled", "leak", "double free", "use after free", "null pointer",
+    "stack trace", "traceback", "exception", "/admin", "DROP TABLE", "<script", "../",
+};
+#define NFILTER_NEEDLES (sizeof(filter_needles) / sizeof(filter_needles[0]))
+
+static void bench_multimatch(void)
+{
+    enum { NITERS = 200000 };
+
+    size_t lens[NFILTER_NEEDLES];
+    for (size_t k = 0; k < NFILTER_NEEDLES; ++k) {
+        lens[k] = lite_strlen(filter_needles[k]);
+    }
+    size_t nbuf = lite_multimatch_bufsize(filter_needles, lens, NFILTER_NEEDLES);
+    uint16_t *buf = xmalloc(nbuf * sizeof(uint16_t));
+    lite_multimatch mm;
+    if (!lite_multimatch_compile(&mm, filter_needles, lens, NFILTER_NEEDLES, buf, nbuf)) {
+        fprintf(stderr, "lite_multimatch_compile() failed\n");
+        abort();
+    }
+
+    size_t nfound = 0;
+    double start = now_ns();
+    for (size_t i = 0; i < NITERS; ++i) {
+        const char *line = log_lines[i % NLOG_LINES];
+        for (size_t k = 0; k < NFILTER_NEEDLES; ++k) {
+            if (lite_strstr(line, filter_needles[k])) {
+                ++nfound;
+                break;
+            }
+        }
+    }
+    report("lite_strstr loop, 50 needles", start, NITERS, "line");
+    sink = nfound;
+
+    nfound = 0;
+    start = now_ns();
+    for (size_t i = 0; i < NITERS; ++i) {
+        const char *line = log_lines[i % NLOG_LINES];
+        if (lite_multimatch_find(&mm, line, lite_strlen(line), NULL)) {
+            ++nfound;
+        }
+    }
+    report("lite_multimatch_find, 50 needles", start, NITERS, "line");
+    sink = nfound;
+
+    free(buf);
+}
+
+static void bench_batch(void)
+{
+    enum { NSTRS = 1 << 16, NROUNDS = 50 };
+
+    // Short strings, scattered over the heap, in the way a vector of parsed headers would be.
+    char **strs = xmalloc(NSTRS * sizeof(char *));
+    char **copies = xmalloc(NSTRS * sizeof(char *));
+    size_t *lens = xmalloc(NSTRS * sizeof(size_t));
+    bool *eqs = xmalloc(NSTRS * sizeof(bool));
+    int *cmps = xmalloc(NSTRS * sizeof(int));
+    srand(1);
+    for (size_t i = 0; i < NSTRS; ++i) {
+        size_t n = 1 + rand() % 16;
+        strs[i] = xmalloc(n + 1 + rand() % 64);
+        copies[i] = xmalloc(n + 1);
+        for (size_t j = 0; j < n; ++j) {
+            strs[i][j] = copies[i][j] = 'a' + rand() % 26;
+        }
+        strs[i][n] = copies[i][n] = '\0';
+    }
+    for (size_t i = NSTRS - 1; i; --i) {
+        size_t j = rand() % (i + 1);
+        char *tmp = strs[i]; strs[i] = strs[j]; strs[j] = tmp;
+        tmp = copies[i]; copies[i] = copies[j]; copies[j] = tmp;
+    }
+    const char *const *cstrs = (const char *const *) strs;
+    const char *const *ccopies = (const char *const *) copies;
+
+    double start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < NSTRS; ++i) {
+            lens[i] = lite_strlen(cstrs[i]);
+        }
+        sink = lens[r];
+    }
+    report("lite_strlen loop", start, (size_t) NSTRS * NROUNDS, "elem");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_strlen_batch(cstrs, lens, NSTRS);
+        sink = lens[r];
+    }
+    report("lite_strlen_batch", start, (size_t) NSTRS * NROUNDS, "elem");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < NSTRS; ++i) {
+            eqs[i] = lite_memcmp(cstrs[i], ccopies[i], lens[i]) == 0;
+        }
+        sink = eqs[r];
+    }
+    report("lite_memcmp loop", start, (size_t) NSTRS * NROUNDS, "elem");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_memeq_batch((const void *const *) cstrs, (const void *const *) ccopies, lens, eqs, NSTRS);
+        sink = eqs[r];
+    }
+    report("lite_memeq_batch", start, (size_t) NSTRS * NROUNDS, "elem");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < NSTRS; ++i) {
+            cmps[i] = lite_strcmp(cstrs[i], ccopies[i]);
+        }
+        sink = cmps[r];
+    }
+    report("lite_strcmp loop", start, (size_t) NSTRS * NROUNDS, "elem");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_strcmp_batch(cstrs, ccopies, cmps, NSTRS);
+        sink = cmps[r];
+    }
+    report("lite_strcmp_batch", start, (size_t) NSTRS * NROUNDS, "elem");
+
+    for (size_t i = 0; i < NSTRS; ++i) {
+        free(strs[i]);
+        free(copies[i]);
+    }
+    free(strs);
+    free(copies);
+    free(lens);
+    free(eqs);
+    free(cmps);
+}
+
+static int strcmp_qsort(const void *a, const void *b)
+{
+    return strcmp(*(const char *const *) a, *(const char *const *) b);
+}
+
+static void bench_strsort(size_t n)
+{
+    enum { NTOTAL = 1 << 20 };
+    size_t nrounds = NTOTAL / n;
+
+    // Keys that share prefixes, in the way identifiers or header names do.
+    static const char *prefixes[] = {"x-request-", "content-", "accept-", "", "user_", "sys."};
+    char **strs = xmalloc(n * sizeof(char *));
+    char **sorted = xmalloc(n * sizeof(char *));
+    lite_strentry *entries = xmalloc(n * sizeof(lite_strentry));
+    srand(1);
+    for (size_t i = 0; i < n; ++i) {
+        const char *prefix = prefixes[rand() % 6];
+        size_t nprefix = lite_strlen(prefix);
+        size_t nsuffix = 1 + rand() % 8;
+        strs[i] = xmalloc(nprefix + nsuffix + 1);
+        lite_memcpy(strs[i], prefix, nprefix);
+        for (size_t j = 0; j < nsuffix; ++j) {
+            strs[i][nprefix + j] = 'a' + rand() % 26;
+        }
+        strs[i][nprefix + nsuffix] = '\0';
+    }
+
+    char name[64];
+    double start = now_ns();
+    for (size_t r = 0; r < nrounds; ++r) {
+        lite_memcpy(sorted, strs, n * sizeof(char *));
+        qsort(sorted, n, sizeof(char *), strcmp_qsort);
+        sink = (size_t) sorted[r % n];
+    }
+    snprintf(name, sizeof(name), "qsort + strcmp, %zu entries", n);
+    report(name, start, nrounds * n, "elem");
+
+    start = now_ns();
+    for (size_t r = 0; r < nrounds; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            lite_strentry_init(&entries[i], strs[i], lite_strlen(strs[i]));
+        }
+        lite_strsort(entries, n);
+        sink = (size_t) entries[r % n].str;
+    }
+    snprintf(name, sizeof(name), "lite_strsort (with init), %zu entries", n);
+    report(name, start, nrounds * n, "elem");
+
+    start = now_ns();
+    for (size_t r = 0; r < nrounds; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            sink = (size_t) bsearch(&strs[i], sorted, n, sizeof(char *), strcmp_qsort);
+        }
+    }
+    snprintf(name, sizeof(name), "bsearch + strcmp, %zu entries", n);
+    report(name, start, nrounds * n, "lookup");
+
+    start = now_ns();
+    for (size_t r = 0; r < nrounds; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            sink = (size_t) lite_strbsearch(entries, n, strs[i], lite_strlen(strs[i]));
+        }
+    }
+    snprintf(name, sizeof(name), "lite_strbsearch, %zu entries", n);
+    report(name, start, nrounds * n, "lookup");
+
+    for (size_t i = 0; i < n; ++i) {
+        free(strs[i]);
+    }
+    free(strs);
+    free(sorted);
+    free(entries);
+}
+
+static void bench_integers(void)
+{
+    enum { NVALUES = 1 << 12, NROUNDS = 200 };
+
+    // Mostly short numbers, as in lengths, counters and status codes.
+    uint64_t *values = xmalloc(NVALUES * sizeof(uint64_t));
+    char (*strs)[LITE_U64TOA_BUFSIZE] = xmalloc(NVALUES * LITE_U64TOA_BUFSIZE);
+    srand(1);
+    for (size_t i = 0; i < NVALUES; ++i) {
+        values[i] = ((uint64_t) rand()) >> (rand() % 31);
+        lite_u64toa(strs[i], values[i]);
+    }
+
+    char buf[LITE_U64TOA_BUFSIZE];
+    double start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < NVALUES; ++i) {
+            sink = snprintf(buf, sizeof(buf), "%llu", (unsigned long long) values[i]);
+        }
+    }
+    report("snprintf", start, (size_t) NVALUES * NROUNDS, "number");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < NVALUES; ++i) {
+            sink = lite_u64toa(buf, values[i]) - buf;
+        }
+    }
+    report("lite_u64toa", start, (size_t) NVALUES * NROUNDS, "number");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < NVALUES; ++i) {
+            sink = strtoull(strs[i], NULL, 10);
+        }
+    }
+    report("strtoull", start, (size_t) NVALUES * NROUNDS, "number");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < NVALUES; ++i) {
+            uint64_t v = 0;
+            lite_parse_u64(strs[i], lite_strlen(strs[i]), &v);
+            sink = v;
+        }
+    }
+    report("lite_parse_u64", start, (size_t) NVALUES * NROUNDS, "number");
+
+    free(values);
+    free(strs);
+}
+
+static void bench_memset(void)
+{
+    enum { NROUNDS = 1 << 22 };
+
+    // Sized like small sentinel-initialized arrays and struct templates.
+    static char buf[64] __attribute__((aligned(8)));
+    // The hand loop stores 'uint32_t's, so it gets a buffer of that type rather than 'buf'.
+    static uint32_t words[16];
+    static const char template[12] = "\x01\x00\x00\x00\xff\xff\xff\xff\x00\x00\x80\x3f";
+
+    double start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        memset(buf, (int) r, 48);
+        LITE_COMPILER_BARRIER();
+    }
+    report("memset, 48 bytes", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_memset(buf, r, 48);
+        LITE_COMPILER_BARRIER();
+    }
+    report("lite_memset, 48 bytes", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < 12; ++i) {
+            words[i] = r;
+            LITE_COMPILER_BARRIER();
+        }
+    }
+    report("hand loop, 12 uint32_t", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_memset32(buf, r, 12);
+        LITE_COMPILER_BARRIER();
+    }
+    report("lite_memset32, 12 uint32_t", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < 4; ++i) {
+            lite_memcpy(buf + i * 12, template, 12);
+        }
+        LITE_COMPILER_BARRIER();
+    }
+    report("lite_memcpy loop, 4 x 12-byte template", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_memset_pattern(buf, template, 12, 48);
+        LITE_COMPILER_BARRIER();
+    }
+    report("lite_memset_pattern, 4 x 12-byte template", start, NROUNDS, "call");
+
+    sink = buf[47] + words[11];
+}
+
+static void bench_xlat(void)
+{
+    enum { NROUNDS = 1 << 22 };
+
+    // Sized like a hostname or header name being normalized into a lookup key.
+    static const char key[] = "Mail.Example-Host_Name.COM:443/x";
+    static char buf[32];
+    unsigned char table[256];
+    for (int i = 0; i < 256; ++i) {
+        table[i] = (i >= 'A' && i <= 'Z') ? i + 32 : i;
+    }
+
+    double start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0; i < 32; ++i) {
+            unsigned char c = key[i];
+            buf[i] = (c >= 'A' && c <= 'Z') ? c + 32 : c;
+            LITE_COMPILER_BARRIER();
+        }
+    }
+    report("hand tolower loop, 32 bytes", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_memxlat(buf, key, table, 32);
+        LITE_COMPILER_BARRIER();
+    }
+    report("lite_memxlat, 32 bytes", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_ascii_tolower_mem(buf, key, 32);
+        LITE_COMPILER_BARRIER();
+    }
+    report("lite_ascii_tolower_mem, 32 bytes", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        for (size_t i = 0, j = 31; i < j; ++i, --j) {
+            char c = buf[i];
+            buf[i] = buf[j];
+            buf[j] = c;
+            LITE_COMPILER_BARRIER();
+        }
+    }
+    report("hand reverse loop, 32 bytes", start, NROUNDS, "call");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        lite_memrev(buf, 32);
+        LITE_COMPILER_BARRIER();
+    }
+    report("lite_memrev, 32 bytes", start, NROUNDS, "call");
+
+    sink = buf[31];
+}
+
+static void bench_par(void)
+{
+    enum { NROUNDS = 10 };
+    size_t n = (size_t) 256 * 1024 * 1024;
+
+    // The needle is near the end, so every search scans almost the whole buffer.
+    char *buf = xmalloc(n);
+    lite_memset_aligned16(buf, 'a', n);
+    lite_memcpy(buf + n - 100, "\r\n\r\n", 4);
+    size_t nbytes = (size_t) NROUNDS * n;
+
+    double start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        sink = (size_t) lite_memchr(buf, '\r', n);
+    }
+    report("lite_memchr, 256 MiB", start, nbytes / 1024, "KiB");
+
+    start = now_ns();
+    for (size_t r = 0; r < NROUNDS; ++r) {
+        sink = (size_t) memchr(buf, '\r', n);
+    }
+    report("memchr, 256 MiB", start, nbytes / 1024, "KiB");
+
+    for (size_t nthreads = 0; nthreads <= 8; nthreads = nthreads ? nthreads * 2 : 1) {
+        lite_par_pool *pool = lite_par_pool_new(nthreads);
+        if (!pool) {
+            perror("lite_par_pool_new");
+            abort();
+        }
+        char name[64];
+
+        start = now_ns();
+        for (size_t r = 0; r < NROUNDS; ++r) {
+            sink = (size_t) lite_par_memchr(pool, buf, '\r', n);
+        }
+        snprintf(name, sizeof(name), "lite_par_memchr, 256 MiB, 1+%zu threads", nthreads);
+        report(name, start, nbytes / 1024, "KiB");
+
+        start = now_ns();
+        for (size_t r = 0; r < NROUNDS; ++r) {
+            sink = (size_t) lite_par_memmem(pool, buf, n, "\r\n\r\n", 4);
+        }
+        snprintf(name, sizeof(name), "lite_par_memmem, 256 MiB, 1+%zu threads", nthreads);
+        report(name, start, nbytes / 1024, "KiB");
+
+        lite_par_pool_free(pool);
+    }
+
+    free(buf);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+int main()
+{
+    bench_memset();
+    bench_multimatch();
+    bench_batch();
+    bench_strsort(10);
+    bench_strsort(100);
+    bench_strsort(1000);
+    bench_integers();
+    bench_xlat();
+    bench_par();
+
+    return 0;
+}
@@ -31,6 +31,96 @@
 // have significant startup overhead).
 #define LITE_COMPILER_BARRIER() __asm__ volatile ("" ::: "memory")
 
+// Per-function counters, compiled in only with '-DLITE_STATS'; see 'lite_stats.h'.
+#ifdef LITE_STATS
+# include "lite_stats.h"
+#else
+# define LITE_STATS_SCOPE(Fn_, Nbytes_)
+# define LITE_STATS_BYTES(Nbytes_) ((void) 0)
+#endif
+
+// Like 'htobe64()' from <endian.h>: after this, comparing two words read from memory as integers
+// orders them the same way as 'lite_memcmp()' orders their bytes.
+LITE_INHEADER uint64_t lite_htobe64(uint64_t x)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return __builtin_bswap64(x);
+#else
+    return x;
+#endif
+}
+
+// Loads a possibly unaligned word; '__builtin_memcpy()' with a constant size compiles to a single
+// load, even with '-fno-builtin' (as 'liblite_preload.so' is built), which plain 'memcpy()' would
+// turn into a call.
+LITE_INHEADER uint64_t lite_load64(const void *p)
+{
+    uint64_t x;
+    __builtin_memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+// Same as 'lite_load64()', but the first byte in memory always ends up in the lowest 8 bits.
+LITE_INHEADER uint64_t lite_load64le(const void *p)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return lite_load64(p);
+#else
+    return __builtin_bswap64(lite_load64(p));
+#endif
+}
+
+LITE_INHEADER uint32_t lite__load32(const void *p)
+{
+    uint32_t x;
+    __builtin_memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+// 'lite_strcmp()' and 'lite_strncmp()' compare a word at a time, and so may read up to 7 bytes
+// past the terminating '\0'. That is harmless as long as the read does not cross into the next
+// page, which might not be mapped: loads that would are replaced with a byte at a time. 4096 is
+// the smallest page size in use; larger ones are multiples of it.
+#define LITE__PAGE_SIZE 4096
+
+// ...but memory error detectors do not know it is harmless.
+#if defined(__SANITIZE_ADDRESS__)
+# define LITE__NO_SANITIZE __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+# if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#  define LITE__NO_SANITIZE __attribute__((no_sanitize("address", "memory")))
+# endif
+#endif
+#ifndef LITE__NO_SANITIZE
+# define LITE__NO_SANITIZE
+#endif
+
+LITE_INHEADER bool lite__can_load64(const char *p)
+{
+    return ((uintptr_t) p & (LITE__PAGE_SIZE - 1)) <= LITE__PAGE_SIZE - 8;
+}
+
+LITE_INHEADER LITE__NO_SANITIZE uint64_t lite__load64_unchecked(const char *p)
+{
+    uint64_t x;
+    __builtin_memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+// Has the high bit set in every byte of 'x' that is zero, and no other bits.
+LITE_INHEADER uint64_t lite__zero_bytes(uint64_t x)
+{
+    const uint64_t low7 = 0x7f7f7f7f7f7f7f7fu;
+    return ~(((x & low7) + low7) | x | low7);
+}
+
+// Returns the index (in memory order) of the first byte of a word, as loaded from memory, that
+// has any bits set in non-zero 't': byte-swapped, that is the most significant one.
+LITE_INHEADER size_t lite__first_byte(uint64_t t)
+{
+    return __builtin_clzll(lite_htobe64(t)) / 8;
+}
+
 LITE_INHEADER void *lite_memcpy_fw(void *dst, const void *src, size_t n)
 {
     for (size_t i = 0; i < n; ++i) {
@@ -50,10 +140,21 @@ LITE_INHEADER void *lite_memcpy_bw(void *dst, const void *src, size_t n)
     return dst;
 }
 
-#define lite_memcpy lite_memcpy_fw
+// Unlike 'lite_memcpy_fw()' and 'lite_memcpy_bw()', which 'lite_memmove()' uses on overlapping
+// buffers, this one tells the compiler that 'dst' and 'src' do not overlap.
+LITE_INHEADER void *lite_memcpy(void *restrict dst, const void *restrict src, size_t n)
+{
+    LITE_STATS_SCOPE(memcpy, n);
+    for (size_t i = 0; i < n; ++i) {
+        ((char *) dst)[i] = ((const char *) src)[i];
+        LITE_COMPILER_BARRIER();
+    }
+    return dst;
+}
 
 LITE_INHEADER void *lite_memmove(void *dst, const void *src, size_t n)
 {
+    LITE_STATS_SCOPE(memmove, n);
     uintptr_t dst_i = (uintptr_t) dst;
     uintptr_t src_i = (uintptr_t) src;
     if (dst_i < src_i) {
@@ -64,7 +165,7 @@ LITE_INHEADER void *lite_memmove(void *dst, const void *src, size_t n)
     return dst;
 }
 
-LITE_INHEADER void *lite_memccpy(void *dst, const void *src, char c, size_t n)
+LITE_INHEADER void *lite_memccpy(void *restrict dst, const void *restrict src, char c, size_t n)
 {
     for (size_t i = 0; i < n; ++i) {
         if ((((char *) dst)[i] = ((const char *) src)[i]) == c) {
@@ -77,6 +178,7 @@ LITE_INHEADER void *lite_memccpy(void *dst, const void *src, char c, size_t n)
 
 LITE_INHEADER void *lite_memset(void *p, char c, size_t n)
 {
+    LITE_STATS_SCOPE(memset, n);
     for (size_t i = 0; i < n; ++i) {
         ((char *) p)[i] = c;
         LITE_COMPILER_BARRIER();
@@ -84,17 +186,177 @@ LITE_INHEADER void *lite_memset(void *p, char c, size_t n)
     return p;
 }
 
-LITE_INHEADER char *lite_strcpy(char *dst, const char *src)
+// Copies and fills of buffers that are known to be aligned, such as fields of fixed-layout
+// structures: whole 8-byte words are moved at a time, followed by the remaining bytes, if any.
+// 'dst' and 'src' (or 'p') must be aligned to 8 or 16 bytes, respectively.
+
+LITE_INHEADER void *lite_memcpy_aligned8(void *restrict dst, const void *restrict src, size_t n)
+{
+    char *d = __builtin_assume_aligned(dst, 8);
+    const char *s = __builtin_assume_aligned(src, 8);
+    size_t i = 0;
+    for (; n - i >= 8; i += 8) {
+        __builtin_memcpy(d + i, s + i, 8);
+        LITE_COMPILER_BARRIER();
+    }
+    lite_memcpy(d + i, s + i, n - i);
+    return dst;
+}
+
+LITE_INHEADER void *lite_memcpy_aligned16(void *restrict dst, const void *restrict src, size_t n)
+{
+    char *d = __builtin_assume_aligned(dst, 16);
+    const char *s = __builtin_assume_aligned(src, 16);
+    size_t i = 0;
+    for (; n - i >= 16; i += 16) {
+        __builtin_memcpy(d + i, s + i, 16);
+        LITE_COMPILER_BARRIER();
+    }
+    lite_memcpy_aligned8(d + i, s + i, n - i);
+    return dst;
+}
+
+LITE_INHEADER void *lite_memset_aligned8(void *p, char c, size_t n)
+{
+    char *d = __builtin_assume_aligned(p, 8);
+    uint64_t w = 0x0101010101010101u * (unsigned char) c;
+    size_t i = 0;
+    for (; n - i >= 8; i += 8) {
+        __builtin_memcpy(d + i, &w, 8);
+        LITE_COMPILER_BARRIER();
+    }
+    lite_memset(d + i, c, n - i);
+    return p;
+}
+
+LITE_INHEADER void *lite_memset_aligned16(void *p, char c, size_t n)
+{
+    char *d = __builtin_assume_aligned(p, 16);
+    uint64_t w[2];
+    w[0] = w[1] = 0x0101010101010101u * (unsigned char) c;
+    size_t i = 0;
+    for (; n - i >= 16; i += 16) {
+        __builtin_memcpy(d + i, w, 16);
+        LITE_COMPILER_BARRIER();
+    }
+    lite_memset_aligned8(d + i, c, n - i);
+    return p;
+}
+
+// Fills with wider values. 'lite_memset16()', 'lite_memset32()' and 'lite_memset64()' store 'n'
+// copies of 'v' (so 'p' must have room for 'n * sizeof(v)' bytes), in native byte order; 'p' need
+// not be aligned.
+
+LITE_INHEADER void lite__memset_word(char *d, uint64_t w, size_t nbytes)
+{
+    size_t i = 0;
+    for (; nbytes - i >= 8; i += 8) {
+        __builtin_memcpy(d + i, &w, 8);
+        LITE_COMPILER_BARRIER();
+    }
+    lite_memcpy(d + i, &w, nbytes - i);
+}
+
+LITE_INHEADER void *lite_memset16(void *p, uint16_t v, size_t n)
+{
+    lite__memset_word(p, 0x0001000100010001u * v, n * 2);
+    return p;
+}
+
+LITE_INHEADER void *lite_memset32(void *p, uint32_t v, size_t n)
+{
+    lite__memset_word(p, 0x0000000100000001u * v, n * 4);
+    return p;
+}
+
+LITE_INHEADER void *lite_memset64(void *p, uint64_t v, size_t n)
+{
+    lite__memset_word(p, v, n * 8);
+    return p;
+}
+
+// Copies 'n <= 16' bytes with at most two (overlapping) fixed-size loads and stores.
+LITE_INHEADER void lite__memcpy_upto16(char *restrict d, const char *restrict s, size_t n)
+{
+    if (n >= 8) {
+        __builtin_memcpy(d, s, 8);
+        __builtin_memcpy(d + n - 8, s + n - 8, 8);
+    } else if (n >= 4) {
+        __builtin_memcpy(d, s, 4);
+        __builtin_memcpy(d + n - 4, s + n - 4, 4);
+    } else if (n >= 2) {
+        __builtin_memcpy(d, s, 2);
+        __builtin_memcpy(d + n - 2, s + n - 2, 2);
+    } else if (n == 1) {
+        *d = *s;
+    }
+}
+
+// Fills 'p[0..n)' with repeated copies of 'pat[0..npat)'; the last copy is truncated if 'npat'
+// does not divide 'n'.
+LITE_INHEADER void *lite_memset_pattern(void *p, const void *pat, size_t npat, size_t n)
+{
+    char *d = p;
+    const char *s = pat;
+    if (npat == 0) {
+        return p;
+    }
+    // Not worth setting up 'ext' below for a single copy, or for less than a word.
+    if (n <= npat || n < 8) {
+        for (size_t k = 0; k < n; k += npat) {
+            lite_memcpy(d + k, s, n - k < npat ? n - k : npat);
+        }
+        return p;
+    }
+    if (npat > 16) {
+        for (size_t k = 0; k < n; k += npat) {
+            size_t m = n - k < npat ? n - k : npat;
+            size_t i = 0;
+            for (; m - i >= 8; i += 8) {
+                __builtin_memcpy(d + k + i, s + i, 8);
+                LITE_COMPILER_BARRIER();
+            }
+            lite_memcpy(d + k + i, s + i, m - i);
+        }
+        return p;
+    }
+
+    // 'ext' is the pattern repeated to 'period + 8' bytes, where 'period' is the smallest multiple
+    // of 'npat' that is at least 8, so that 'ext[j..j + 8)' is the next word to store for any
+    // 'j < period'. Words are loaded from here rather than from what has just been stored to 'p',
+    // as a load that straddles recent stores cannot be forwarded from them.
+    char ext[32];
+    size_t period = npat * ((8 + npat - 1) / npat);
+    for (size_t i = 0; i < period + 8; i += npat) {
+        lite__memcpy_upto16(ext + i, s, npat);
+    }
+    size_t j = 0;
+    size_t k = 0;
+    for (; n - k >= 8; k += 8) {
+        __builtin_memcpy(d + k, ext + j, 8);
+        j += 8;
+        if (j >= period) {
+            j -= period;
+        }
+        LITE_COMPILER_BARRIER();
+    }
+    lite_memcpy(d + k, ext + j, n - k);
+    return p;
+}
+
+LITE_INHEADER char *lite_strcpy(char *restrict dst, const char *restrict src)
 {
+    LITE_STATS_SCOPE(strcpy, 0);
     size_t i = 0;
     while ((dst[i] = src[i]) != '\0') {
         ++i;
         LITE_COMPILER_BARRIER();
     }
+    LITE_STATS_BYTES(i);
     return dst;
 }
 
-LITE_INHEADER char *lite_strncpy(char *dst, const char *src, size_t n)
+LITE_INHEADER char *lite_strncpy(char *restrict dst, const char *restrict src, size_t n)
 {
     for (size_t i = 0; i < n; ++i) {
         if ((dst[i] = src[i]) == '\0') {
@@ -107,17 +369,19 @@ LITE_INHEADER char *lite_strncpy(char *dst, const char *src, size_t n)
     return dst;
 }
 
-LITE_INHEADER char *lite_stpcpy(char *dst, const char *src)
+LITE_INHEADER char *lite_stpcpy(char *restrict dst, const char *restrict src)
 {
+    LITE_STATS_SCOPE(stpcpy, 0);
     size_t i = 0;
     while ((dst[i] = src[i]) != '\0') {
         ++i;
         LITE_COMPILER_BARRIER();
     }
+    LITE_STATS_BYTES(i);
     return dst + i;
 }
 
-LITE_INHEADER char *lite_stpncpy(char *dst, const char *src, size_t n)
+LITE_INHEADER char *lite_stpncpy(char *restrict dst, const char *restrict src, size_t n)
 {
     for (size_t i = 0; i < n; ++i) {
         if ((dst[i] = src[i]) == '\0') {
@@ -131,16 +395,19 @@ LITE_INHEADER char *lite_stpncpy(char *dst, const char *src, size_t n)
 
 LITE_INHEADER size_t lite_strlen(const char *s)
 {
+    LITE_STATS_SCOPE(strlen, 0);
     size_t i = 0;
     while (s[i] != '\0') {
         ++i;
         LITE_COMPILER_BARRIER();
     }
+    LITE_STATS_BYTES(i);
     return i;
 }
 
 LITE_INHEADER size_t lite_strnlen(const char *s, size_t n)
 {
+    LITE_STATS_SCOPE(strnlen, n);
     size_t i = 0;
     while (i < n && s[i] != '\0') {
         ++i;
@@ -149,13 +416,13 @@ LITE_INHEADER size_t lite_strnlen(const char *s, size_t n)
     return i;
 }
 
-LITE_INHEADER char *lite_strcat(char *dst, const char *src)
+LITE_INHEADER char *lite_strcat(char *restrict dst, const char *restrict src)
 {
     lite_strcpy(dst + lite_strlen(dst), src);
     return dst;
 }
 
-LITE_INHEADER char *lite_strncat(char *dst, const char *src, size_t n)
+LITE_INHEADER char *lite_strncat(char *restrict dst, const char *restrict src, size_t n)
 {
     char *p = dst + lite_strlen(dst);
     size_t i = 0;
@@ -173,6 +440,7 @@ LITE_INHEADER char *lite_strncat(char *dst, const char *src, size_t n)
 
 LITE_INHEADER void *lite_memchr(const void *p, char c, size_t n)
 {
+    LITE_STATS_SCOPE(memchr, n);
     const char *sp = p;
     const char *sp_end = sp + n;
     for (; sp != sp_end; ++sp) {
@@ -208,54 +476,105 @@ LITE_INHEADER void *lite_memrchr(const void *p, char c, size_t n)
     return NULL;
 }
 
+// 'lite_memcmp()', 'lite_strcmp()' and 'lite_strncmp()' compare 8 bytes at a time: the first
+// differing byte (or, for strings, the first byte that differs or is '\0' in 'p') is located
+// in the XOR of the words with a byte swap and a count of leading zero bits.
+
 LITE_INHEADER int lite_memcmp(const void *p, const void *q, size_t n)
 {
+    LITE_STATS_SCOPE(memcmp, n);
     const char *sp = p;
     const char *sq = q;
-    for (size_t i = 0; i < n; ++i) {
-        unsigned char cp = sp[i];
-        unsigned char cq = sq[i];
-        if (cp != cq) {
-            return cp < cq ? -1 : 1;
+    if (n < 8) {
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char cp = sp[i];
+            unsigned char cq = sq[i];
+            if (cp != cq) {
+                return cp < cq ? -1 : 1;
+            }
+            LITE_COMPILER_BARRIER();
+        }
+        return 0;
+    }
+    // The last word is loaded so that it ends at the last byte, overlapping bytes that are
+    // already known to be equal.
+    for (size_t i = 0; ; i += 8) {
+        if (n - i < 8) {
+            i = n - 8;
+        }
+        uint64_t wp = lite_load64(sp + i);
+        uint64_t wq = lite_load64(sq + i);
+        if (wp != wq) {
+            return lite_htobe64(wp) < lite_htobe64(wq) ? -1 : 1;
+        }
+        if (i + 8 == n) {
+            return 0;
         }
         LITE_COMPILER_BARRIER();
     }
-    return 0;
 }
 
-LITE_INHEADER int lite_strcmp(const char *p, const char *q)
+LITE_INHEADER LITE__NO_SANITIZE int lite_strcmp(const char *p, const char *q)
 {
-    for (size_t i = 0; ; ++i) {
-        unsigned char cp = p[i];
-        if (cp == '\0') {
-            return q[i] == '\0' ? 0 : -1;
+    LITE_STATS_SCOPE(strcmp, 0);
+    for (size_t i = 0; ; ) {
+        if (lite__can_load64(p + i) && lite__can_load64(q + i)) {
+            uint64_t wp = lite__load64_unchecked(p + i);
+            uint64_t wq = lite__load64_unchecked(q + i);
+            uint64_t t = (wp ^ wq) | lite__zero_bytes(wp);
+            if (t == 0) {
+                i += 8;
+                LITE_COMPILER_BARRIER();
+                continue;
+            }
+            i += lite__first_byte(t);
+        } else if (p[i] != '\0' && p[i] == q[i]) {
+            ++i;
+            LITE_COMPILER_BARRIER();
+            continue;
         }
+        // 'p[i]' is either '\0' or differs from 'q[i]'; if it is '\0', the strings are equal
+        // only if 'q[i]' is too, and otherwise '\0' orders first.
+        unsigned char cp = p[i];
         unsigned char cq = q[i];
-        if (cp != cq) {
-            return cp < cq ? -1 : 1;
-        }
-        LITE_COMPILER_BARRIER();
+        LITE_STATS_BYTES(i + 1);
+        return cp == cq ? 0 : (cp < cq ? -1 : 1);
     }
 }
 
-LITE_INHEADER int lite_strncmp(const char *p, const char *q, size_t n)
+LITE_INHEADER LITE__NO_SANITIZE int lite_strncmp(const char *p, const char *q, size_t n)
 {
-    for (size_t i = 0; i < n; ++i) {
-        unsigned char cp = p[i];
-        if (cp == '\0') {
-            return q[i] == '\0' ? 0 : -1;
+    LITE_STATS_SCOPE(strncmp, n);
+    for (size_t i = 0; i < n; ) {
+        if (lite__can_load64(p + i) && lite__can_load64(q + i)) {
+            uint64_t wp = lite__load64_unchecked(p + i);
+            uint64_t wq = lite__load64_unchecked(q + i);
+            // In memory order, so that the bytes at and past 'n' can be masked off.
+            uint64_t t = lite_htobe64((wp ^ wq) | lite__zero_bytes(wp));
+            if (n - i < 8) {
+                t &= ~(UINT64_MAX >> ((n - i) * 8));
+            }
+            if (t == 0) {
+                i += 8;
+                LITE_COMPILER_BARRIER();
+                continue;
+            }
+            i += __builtin_clzll(t) / 8;
+        } else if (p[i] != '\0' && p[i] == q[i]) {
+            ++i;
+            LITE_COMPILER_BARRIER();
+            continue;
         }
+        unsigned char cp = p[i];
         unsigned char cq = q[i];
-        if (cp != cq) {
-            return cp < cq ? -1 : 1;
-        }
-        LITE_COMPILER_BARRIER();
+        return cp == cq ? 0 : (cp < cq ? -1 : 1);
     }
     return 0;
 }
 
 LITE_INHEADER char *lite_strchr(const char *s, char c)
 {
+    LITE_STATS_SCOPE(strchr, 0);
     for (;; ++s) {
         char cs = *s;
         if (cs == c) {
@@ -342,6 +661,7 @@ LITE_INHEADER bool lite_strstartswith(const char *s, const char *prefix)
 
 LITE_INHEADER char *lite_strstr(const char *haystack, const char *needle)
 {
+    LITE_STATS_SCOPE(strstr, 0);
     char needle0 = *needle;
     if (needle0 == '\0') {
         return (char *) haystack;
@@ -360,6 +680,7 @@ LITE_INHEADER char *lite_strstr(const char *haystack, const char *needle)
 
 LITE_INHEADER void *lite_memmem(const void *haystack, size_t nhaystack, const void *needle, size_t nneedle)
 {
+    LITE_STATS_SCOPE(memmem, nhaystack);
     if (nneedle > nhaystack) {
         return NULL;
     }
@@ -374,6 +695,124 @@ LITE_INHEADER void *lite_memmem(const void *haystack, size_t nhaystack, const vo
     return NULL;
 }
 
+// Needles of up to this many bytes are searched for naively by 'lite_memrmem()'.
+#define LITE_MEMRMEM_NAIVE_MAX 8
+
+LITE_INHEADER void *lite_memrmem(const void *haystack, size_t nhaystack, const void *needle, size_t nneedle)
+{
+    if (nneedle > nhaystack) {
+        return NULL;
+    }
+    const unsigned char *h = haystack;
+    const unsigned char *n = needle;
+    size_t i = nhaystack - nneedle;
+
+    if (nneedle <= LITE_MEMRMEM_NAIVE_MAX) {
+        for (;; --i) {
+            if (lite_memcmp(h + i, n, nneedle) == 0) {
+                return (void *) (h + i);
+            }
+            if (i == 0) {
+                return NULL;
+            }
+            LITE_COMPILER_BARRIER();
+        }
+    }
+
+    // Rabin-Karp, rolling the window from the end. The hash of 'w[0..m)' is 'sum(w[k] * B^k)', so
+    // that prepending a byte and dropping the last one does not need a division.
+    const uint32_t B = 257;
+    uint32_t bpow = 1;
+    uint32_t hn = 0;
+    uint32_t hh = 0;
+    for (size_t k = nneedle; k;) {
+        --k;
+        hn = hn * B + n[k];
+        hh = hh * B + h[i + k];
+        if (k) {
+            bpow *= B;
+        }
+        LITE_COMPILER_BARRIER();
+    }
+    for (;; --i) {
+        if (hh == hn && lite_memcmp(h + i, n, nneedle) == 0) {
+            return (void *) (h + i);
+        }
+        if (i == 0) {
+            return NULL;
+        }
+        hh = h[i - 1] + B * (hh - h[i - 1 + nneedle] * bpow);
+        LITE_COMPILER_BARRIER();
+    }
+}
+
+LITE_INHEADER char *lite_strrstr(const char *haystack, const char *needle)
+{
+    return lite_memrmem(haystack, lite_strlen(haystack), needle, lite_strlen(needle));
+}
+
+// A needle preprocessed for searching for its last occurrence in worst-case linear time (this is
+// Knuth-Morris-Pratt run over the reversed needle and the reversed haystack).
+//
+// The caller supplies the table: 'fail' must have room for 'nneedle' elements.
+
+typedef struct {
+    const unsigned char *needle;
+    size_t nneedle;
+    size_t *fail;
+} lite_rneedle;
+
+LITE_INHEADER void lite_rneedle_init(lite_rneedle *nd, const void *needle, size_t nneedle, size_t *fail)
+{
+    const unsigned char *n = needle;
+    nd->needle = n;
+    nd->nneedle = nneedle;
+    nd->fail = fail;
+
+    // 'fail[j]' is the length of the longest proper border of the last 'j + 1' bytes of the needle.
+    if (nneedle) {
+        fail[0] = 0;
+    }
+    size_t k = 0;
+    for (size_t j = 1; j < nneedle; ++j) {
+        while (k && n[nneedle - 1 - j] != n[nneedle - 1 - k]) {
+            k = fail[k - 1];
+        }
+        if (n[nneedle - 1 - j] == n[nneedle - 1 - k]) {
+            ++k;
+        }
+        fail[j] = k;
+        LITE_COMPILER_BARRIER();
+    }
+}
+
+LITE_INHEADER void *lite_rneedle_find(const lite_rneedle *nd, const void *haystack, size_t nhaystack)
+{
+    const unsigned char *h = haystack;
+    const unsigned char *n = nd->needle;
+    size_t m = nd->nneedle;
+    if (m > nhaystack) {
+        return NULL;
+    }
+    if (m == 0) {
+        return (void *) (h + nhaystack);
+    }
+    size_t k = 0;
+    for (size_t i = nhaystack; i;) {
+        --i;
+        while (k && h[i] != n[m - 1 - k]) {
+            k = nd->fail[k - 1];
+        }
+        if (h[i] == n[m - 1 - k]) {
+            if (++k == m) {
+                return (void *) (h + i);
+            }
+        }
+        LITE_COMPILER_BARRIER();
+    }
+    return NULL;
+}
+
 LITE_INHEADER char *lite_strtok_r(char *s, const char *delim, char **saveptr)
 {
     if (!s) {
@@ -400,3 +839,673 @@ LITE_INHEADER char *lite_strtok_r(char *s, const char *delim, char **saveptr)
         return s;
     }
 }
+
+// 32-bit FNV-1a. Not suitable for hash tables exposed to untrusted input.
+
+#define LITE_MEMHASH_INIT 2166136261u
+
+LITE_INHEADER uint32_t lite_memhash_step(uint32_t h, unsigned char c)
+{
+    return (h ^ c) * 16777619u;
+}
+
+LITE_INHEADER uint32_t lite_memhash(const void *p, size_t n)
+{
+    const unsigned char *sp = p;
+    uint32_t h = LITE_MEMHASH_INIT;
+    for (size_t i = 0; i < n; ++i) {
+        h = lite_memhash_step(h, sp[i]);
+        LITE_COMPILER_BARRIER();
+    }
+    return h;
+}
+
+// Known-length comparisons, for strings whose lengths are already known (e.g. from protocol
+// framing), so there is no need to look for a NUL.
+//
+// These compare a word at a time; the last, partial, word is loaded so that it ends at the last
+// byte, overlapping the bytes already compared, rather than being finished byte by byte.
+
+LITE_INHEADER bool lite__memeq_words(const char *p, const char *q, size_t n)
+{
+    if (n < 8) {
+        if (n >= 4) {
+            return lite__load32(p) == lite__load32(q) &&
+                   lite__load32(p + n - 4) == lite__load32(q + n - 4);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (p[i] != q[i]) {
+                return false;
+            }
+            LITE_COMPILER_BARRIER();
+        }
+        return true;
+    }
+    size_t i = 0;
+    for (; n - i > 8; i += 8) {
+        if (lite_load64(p + i) != lite_load64(q + i)) {
+            return false;
+        }
+        LITE_COMPILER_BARRIER();
+    }
+    return lite_load64(p + n - 8) == lite_load64(q + n - 8);
+}
+
+LITE_INHEADER bool lite_memstartswith(const void *s, size_t ns, const void *prefix, size_t nprefix)
+{
+    return ns >= nprefix && lite__memeq_words(s, prefix, nprefix);
+}
+
+LITE_INHEADER bool lite_memendswith(const void *s, size_t ns, const void *suffix, size_t nsuffix)
+{
+    return ns >= nsuffix && lite__memeq_words((const char *) s + ns - nsuffix, suffix, nsuffix);
+}
+
+// Orders 'p[0..np)' and 'q[0..nq)' by content, and then, if one is a prefix of the other, by
+// length, the way C++'s 'std::string_view::compare()' does. Returns -1, 0 or 1.
+LITE_INHEADER int lite_memcmp_len(const void *p, size_t np, const void *q, size_t nq)
+{
+    int r = lite_memcmp(p, q, np < nq ? np : nq);
+    if (r != 0) {
+        return r;
+    }
+    return np == nq ? 0 : (np < nq ? -1 : 1);
+}
+
+// Byte transformations, for normalizing keys. Each of them writes 'n' bytes to 'dst', which may
+// be equal to 'src' (in place), but must not otherwise overlap it, and returns 'dst'.
+
+// 'dst[i] = table[src[i]]'.
+LITE_INHEADER void *lite_memxlat(void *dst, const void *src, const unsigned char table[256], size_t n)
+{
+    unsigned char *d = dst;
+    const unsigned char *s = src;
+    for (size_t i = 0; i < n; ++i) {
+        d[i] = table[s[i]];
+        LITE_COMPILER_BARRIER();
+    }
+    return dst;
+}
+
+// Has the high bit set in every byte of 'x' that is in the range 'lo'..'hi' (both ASCII), and no
+// other bits.
+LITE_INHEADER uint64_t lite__ascii_range_bytes(uint64_t x, unsigned char lo, unsigned char hi)
+{
+    const uint64_t ones = 0x0101010101010101u;
+    const uint64_t high = 0x8080808080808080u;
+    uint64_t low7 = x & ~high;
+    // For bytes below 0x80, the high bit of the sum is set if the byte is at least 'lo' (or
+    // greater than 'hi'); no carry crosses into the next byte.
+    uint64_t ge_lo = low7 + ones * (0x80 - lo);
+    uint64_t gt_hi = low7 + ones * (0x7f - hi);
+    return ge_lo & ~gt_hi & ~x & high;
+}
+
+// Flips bit 5 (the ASCII case bit) in every byte in the range 'lo'..'hi'.
+LITE_INHEADER void *lite__ascii_flipcase_mem(void *dst, const void *src, size_t n, unsigned char lo, unsigned char hi)
+{
+    char *d = dst;
+    const char *s = src;
+    size_t i = 0;
+    for (; n - i >= 8; i += 8) {
+        uint64_t x = lite_load64(s + i);
+        x ^= lite__ascii_range_bytes(x, lo, hi) >> 2;
+        __builtin_memcpy(d + i, &x, sizeof(x));
+        LITE_COMPILER_BARRIER();
+    }
+    for (; i < n; ++i) {
+        unsigned char c = s[i];
+        d[i] = (c >= lo && c <= hi) ? (c ^ 0x20) : c;
+        LITE_COMPILER_BARRIER();
+    }
+    return dst;
+}
+
+// Only 'A'..'Z' are changed; bytes outside of ASCII are copied as they are.
+LITE_INHEADER void *lite_ascii_tolower_mem(void *dst, const void *src, size_t n)
+{
+    return lite__ascii_flipcase_mem(dst, src, n, 'A', 'Z');
+}
+
+// Only 'a'..'z' are changed; bytes outside of ASCII are copied as they are.
+LITE_INHEADER void *lite_ascii_toupper_mem(void *dst, const void *src, size_t n)
+{
+    return lite__ascii_flipcase_mem(dst, src, n, 'a', 'z');
+}
+
+// Reverses 'p[0..n)' in place, and returns 'p'.
+LITE_INHEADER void *lite_memrev(void *p, size_t n)
+{
+    char *s = p;
+    size_t i = 0;
+    size_t j = n;
+    // Swaps whole, byte-swapped, words from both ends while they do not overlap.
+    while (j - i >= 16) {
+        uint64_t a = __builtin_bswap64(lite_load64(s + i));
+        uint64_t b = __builtin_bswap64(lite_load64(s + j - 8));
+        __builtin_memcpy(s + i, &b, sizeof(b));
+        __builtin_memcpy(s + j - 8, &a, sizeof(a));
+        i += 8;
+        j -= 8;
+        LITE_COMPILER_BARRIER();
+    }
+    while (j - i >= 2) {
+        --j;
+        char c = s[i];
+        s[i] = s[j];
+        s[j] = c;
+        ++i;
+        LITE_COMPILER_BARRIER();
+    }
+    return p;
+}
+
+// Batched versions of some of the functions above, for arrays of many short strings.
+//
+// Each of them prefetches the strings that are 'LITE_BATCH_PREFETCH' elements ahead of the current
+// one, so that by the time they are reached, they are likely to be in cache.
+
+#define LITE_BATCH_PREFETCH 8
+
+// Sets 'lens[i]' to 'lite_strlen(strs[i])' for each 'i < n'.
+LITE_INHEADER void lite_strlen_batch(const char *const *strs, size_t *lens, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (n - i > LITE_BATCH_PREFETCH) {
+            __builtin_prefetch(strs[i + LITE_BATCH_PREFETCH]);
+        }
+        lens[i] = lite_strlen(strs[i]);
+    }
+}
+
+// Sets 'out[i]' to 'lite_memcmp(p[i], q[i], lens[i]) == 0' for each 'i < n'.
+LITE_INHEADER void lite_memeq_batch(
+        const void *const *p, const void *const *q, const size_t *lens,
+        bool *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (n - i > LITE_BATCH_PREFETCH) {
+            __builtin_prefetch(p[i + LITE_BATCH_PREFETCH]);
+            __builtin_prefetch(q[i + LITE_BATCH_PREFETCH]);
+        }
+        out[i] = lite_memcmp(p[i], q[i], lens[i]) == 0;
+    }
+}
+
+// Sets 'out[i]' to 'lite_strcmp(p[i], q[i])' for each 'i < n'.
+LITE_INHEADER void lite_strcmp_batch(const char *const *p, const char *const *q, int *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (n - i > LITE_BATCH_PREFETCH) {
+            __builtin_prefetch(p[i + LITE_BATCH_PREFETCH]);
+            __builtin_prefetch(q[i + LITE_BATCH_PREFETCH]);
+        }
+        out[i] = lite_strcmp(p[i], q[i]);
+    }
+}
+
+// An entry of an array of strings to be sorted with 'lite_strsort()' or searched with
+// 'lite_strbsearch()'. 'key' caches the first 8 bytes of the string, zero-padded and big-endian,
+// so that most comparisons are a single integer comparison.
+
+typedef struct {
+    uint64_t key;
+    const char *str;
+    size_t len;
+} lite_strentry;
+
+LITE_INHEADER void lite_strentry_init(lite_strentry *e, const char *s, size_t len)
+{
+    uint64_t key = 0;
+    lite_memcpy(&key, s, len < 8 ? len : 8);
+    e->key = lite_htobe64(key);
+    e->str = s;
+    e->len = len;
+}
+
+// Orders strings as 'lite_memcmp()' would, with a proper prefix ordered before the string; for
+// '\0'-terminated strings, this is the same as 'lite_strcmp()'.
+LITE_INHEADER int lite_strentry_cmp(const lite_strentry *a, const lite_strentry *b)
+{
+    if (a->key != b->key) {
+        return a->key < b->key ? -1 : 1;
+    }
+    size_t n = a->len < b->len ? a->len : b->len;
+    if (n > 8) {
+        int ret = lite_memcmp(a->str + 8, b->str + 8, n - 8);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return a->len == b->len ? 0 : (a->len < b->len ? -1 : 1);
+}
+
+// Arrays of up to this many entries are sorted with insertion sort by 'lite_strsort()'.
+#define LITE_STRSORT_INSERTION_MAX 16
+
+LITE_INHEADER void lite_strsort__swap(lite_strentry *a, lite_strentry *b)
+{
+    lite_strentry tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+// Sorts 'a' with quicksort, switching to insertion sort for small partitions. Not stable.
+LITE_INHEADER void lite_strsort(lite_strentry *a, size_t n)
+{
+    while (n > LITE_STRSORT_INSERTION_MAX) {
+        // Median of three; 'a[0]' and 'a[n - 1]' then also serve as sentinels for the first pass.
+        size_t mid = n / 2;
+        if (lite_strentry_cmp(&a[mid], &a[0]) < 0) {
+            lite_strsort__swap(&a[mid], &a[0]);
+        }
+        if (lite_strentry_cmp(&a[n - 1], &a[mid]) < 0) {
+            lite_strsort__swap(&a[n - 1], &a[mid]);
+            if (lite_strentry_cmp(&a[mid], &a[0]) < 0) {
+                lite_strsort__swap(&a[mid], &a[0]);
+            }
+        }
+        lite_strentry pivot = a[mid];
+
+        size_t i = 0;
+        size_t j = n - 1;
+        for (;;) {
+            while (lite_strentry_cmp(&a[i], &pivot) < 0) {
+                ++i;
+            }
+            while (lite_strentry_cmp(&a[j], &pivot) > 0) {
+                --j;
+            }
+            if (i >= j) {
+                break;
+            }
+            lite_strsort__swap(&a[i], &a[j]);
+            ++i;
+            --j;
+        }
+
+        // Recurse into the smaller half, loop on the larger one.
+        size_t nleft = j + 1;
+        if (nleft < n - nleft) {
+            lite_strsort(a, nleft);
+            a += nleft;
+            n -= nleft;
+        } else {
+            lite_strsort(a + nleft, n - nleft);
+            n = nleft;
+        }
+    }
+
+    for (size_t i = 1; i < n; ++i) {
+        lite_strentry e = a[i];
+        size_t j = i;
+        for (; j && lite_strentry_cmp(&e, &a[j - 1]) < 0; --j) {
+            a[j] = a[j - 1];
+        }
+        a[j] = e;
+    }
+}
+
+// Searches the sorted array 'a' for the string 's' of length 'len'. Returns a pointer to a
+// matching entry, or NULL if there is none.
+LITE_INHEADER lite_strentry *lite_strbsearch(const lite_strentry *a, size_t n, const char *s, size_t len)
+{
+    lite_strentry needle;
+    lite_strentry_init(&needle, s, len);
+    size_t lo = 0;
+    size_t hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int ret = lite_strentry_cmp(&a[mid], &needle);
+        if (ret == 0) {
+            return (lite_strentry *) &a[mid];
+        } else if (ret < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+// Integer formatting and parsing.
+//
+// The formatting functions write the decimal representation of 'v' and a terminating '\0' into
+// 'buf', which must have room for 'LITE_U32TOA_BUFSIZE', 'LITE_U64TOA_BUFSIZE' or
+// 'LITE_I64TOA_BUFSIZE' bytes, respectively. They return a pointer to the terminating '\0', as
+// 'lite_stpcpy()' does.
+
+#define LITE_U32TOA_BUFSIZE 11
+#define LITE_U64TOA_BUFSIZE 21
+#define LITE_I64TOA_BUFSIZE 21
+
+static const char lite__digits2[200] __attribute__((unused)) =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+LITE_INHEADER unsigned lite__ndigits_u64(uint64_t v)
+{
+    for (unsigned n = 1; ; n += 4) {
+        if (v < 10) {
+            return n;
+        }
+        if (v < 100) {
+            return n + 1;
+        }
+        if (v < 1000) {
+            return n + 2;
+        }
+        if (v < 10000) {
+            return n + 3;
+        }
+        v /= 10000;
+    }
+}
+
+LITE_INHEADER char *lite_u64toa(char *buf, uint64_t v)
+{
+    char *end = buf + lite__ndigits_u64(v);
+    *end = '\0';
+    char *p = end;
+    while (v >= 100) {
+        const char *d = &lite__digits2[(v % 100) * 2];
+        v /= 100;
+        p -= 2;
+        p[0] = d[0];
+        p[1] = d[1];
+    }
+    if (v >= 10) {
+        const char *d = &lite__digits2[v * 2];
+        p[-2] = d[0];
+        p[-1] = d[1];
+    } else {
+        p[-1] = '0' + v;
+    }
+    return end;
+}
+
+LITE_INHEADER char *lite_u32toa(char *buf, uint32_t v)
+{
+    // Same as above, but with 32-bit divisions, which are considerably cheaper on most targets.
+    char *end = buf + lite__ndigits_u64(v);
+    *end = '\0';
+    char *p = end;
+    while (v >= 100) {
+        const char *d = &lite__digits2[(v % 100) * 2];
+        v /= 100;
+        p -= 2;
+        p[0] = d[0];
+        p[1] = d[1];
+    }
+    if (v >= 10) {
+        const char *d = &lite__digits2[v * 2];
+        p[-2] = d[0];
+        p[-1] = d[1];
+    } else {
+        p[-1] = '0' + v;
+    }
+    return end;
+}
+
+LITE_INHEADER char *lite_i64toa(char *buf, int64_t v)
+{
+    if (v < 0) {
+        *buf++ = '-';
+        return lite_u64toa(buf, -(uint64_t) v);
+    }
+    return lite_u64toa(buf, v);
+}
+
+// Parses the longest prefix of 's[0..n)' that consists of decimal digits. Returns a pointer past
+// the last digit, or NULL if there are no digits or the value does not fit in 'uint64_t'.
+//
+// Runs of 8 digits are converted at once with SWAR arithmetic.
+LITE_INHEADER char *lite_parse_u64(const char *s, size_t n, uint64_t *out)
+{
+    uint64_t v = 0;
+    size_t i = 0;
+    while (n - i >= 8) {
+        uint64_t x = lite_load64le(s + i);
+        // Each byte must be 0x3? before and after adding 6.
+        uint64_t hi = (x & 0xF0F0F0F0F0F0F0F0u) | (((x + 0x0606060606060606u) & 0xF0F0F0F0F0F0F0F0u) >> 4);
+        if (hi != 0x3333333333333333u) {
+            break;
+        }
+        x = ((x & 0x0F0F0F0F0F0F0F0Fu) * 2561) >> 8;
+        x = ((x & 0x00FF00FF00FF00FFu) * 6553601) >> 16;
+        x = ((x & 0x0000FFFF0000FFFFu) * 42949672960001u) >> 32;
+        if (__builtin_mul_overflow(v, 100000000u, &v) || __builtin_add_overflow(v, x, &v)) {
+            return NULL;
+        }
+        i += 8;
+    }
+    for (; i < n; ++i) {
+        unsigned d = (unsigned char) s[i] - '0';
+        if (d > 9) {
+            break;
+        }
+        if (__builtin_mul_overflow(v, 10u, &v) || __builtin_add_overflow(v, d, &v)) {
+            return NULL;
+        }
+        LITE_COMPILER_BARRIER();
+    }
+    if (i == 0) {
+        return NULL;
+    }
+    *out = v;
+    return (char *) (s + i);
+}
+
+// UTF-8.
+//
+// 'lite_utf8_valid()' rejects overlong encodings, surrogates and code points above U+10FFFF. The
+// other functions assume their input is valid.
+
+LITE_INHEADER bool lite_utf8_valid(const char *s, size_t n)
+{
+    const unsigned char *p = (const unsigned char *) s;
+    size_t i = 0;
+    while (i != n) {
+        // Skip ASCII 8 bytes at a time.
+        while (n - i >= 8 && (lite_load64(p + i) & 0x8080808080808080u) == 0) {
+            i += 8;
+        }
+        if (i == n) {
+            break;
+        }
+
+        unsigned char c = p[i];
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+        // The number of continuation bytes, and the range of the first one (the rest are always
+        // 0x80..0xBF).
+        size_t ncont;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xBF;
+        if (c < 0xC2) {
+            return false;
+        } else if (c < 0xE0) {
+            ncont = 1;
+        } else if (c < 0xF0) {
+            ncont = 2;
+            if (c == 0xE0) {
+                lo = 0xA0;
+            } else if (c == 0xED) {
+                hi = 0x9F;
+            }
+        } else if (c < 0xF5) {
+            ncont = 3;
+            if (c == 0xF0) {
+                lo = 0x90;
+            } else if (c == 0xF4) {
+                hi = 0x8F;
+            }
+        } else {
+            return false;
+        }
+        if (n - i <= ncont) {
+            return false;
+        }
+        if (p[i + 1] < lo || p[i + 1] > hi) {
+            return false;
+        }
+        for (size_t k = 2; k <= ncont; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += ncont + 1;
+        LITE_COMPILER_BARRIER();
+    }
+    return true;
+}
+
+// Returns the number of code points in 's[0..n)'.
+LITE_INHEADER size_t lite_utf8_strlen(const char *s, size_t n)
+{
+    // Counts the bytes that are not continuation bytes (0b10xxxxxx), 8 at a time.
+    size_t ncont = 0;
+    size_t i = 0;
+    for (; n - i >= 8; i += 8) {
+        uint64_t x = lite_load64(s + i);
+        ncont += __builtin_popcountll(x & ~(x << 1) & 0x8080808080808080u);
+    }
+    for (; i < n; ++i) {
+        ncont += (s[i] & 0xC0) == 0x80;
+        LITE_COMPILER_BARRIER();
+    }
+    return n - ncont;
+}
+
+// Returns the length of the longest prefix of 's[0..n)' that is at most 'max' bytes long and does
+// not end in the middle of a code point; for example, for truncating a string to fit in a buffer.
+LITE_INHEADER size_t lite_utf8_prefix_trunc(const char *s, size_t n, size_t max)
+{
+    if (n <= max) {
+        return n;
+    }
+    while (max && (s[max] & 0xC0) == 0x80) {
+        --max;
+        LITE_COMPILER_BARRIER();
+    }
+    return max;
+}
+
+// A set of bytes, as a 256-bit bitmap.
+
+typedef struct {
+    uint64_t bits[4];
+} lite_byteset;
+
+LITE_INHEADER void lite_byteset_add(lite_byteset *set, char c)
+{
+    unsigned char uc = c;
+    set->bits[uc >> 6] |= ((uint64_t) 1) << (uc & 63);
+}
+
+LITE_INHEADER bool lite_byteset_has(const lite_byteset *set, char c)
+{
+    unsigned char uc = c;
+    return (set->bits[uc >> 6] >> (uc & 63)) & 1;
+}
+
+// Initializes 'set' to the bytes of the '\0'-terminated string 'chars', as in the 'needle'
+// argument of 'lite_strcspn()'.
+LITE_INHEADER void lite_byteset_init(lite_byteset *set, const char *chars)
+{
+    lite_memset(set, '\0', sizeof(*set));
+    for (; *chars != '\0'; ++chars) {
+        lite_byteset_add(set, *chars);
+        LITE_COMPILER_BARRIER();
+    }
+}
+
+// Copies that stop on a condition, for parsers that would otherwise find the end of a token with
+// one pass and copy it with another. Each of them copies at most 'n' bytes, does not copy the byte
+// it stopped at, and does not write a terminating '\0'.
+
+typedef enum {
+    LITE_STOP_LIMIT, // 'n' bytes were copied.
+    LITE_STOP_NUL,   // A '\0' was found.
+    LITE_STOP_BYTE,  // A byte from the set was found.
+} lite_stop;
+
+typedef struct {
+    // 'dst + len'; the byte it stopped at is 'src[len]'.
+    char *end;
+    size_t len;
+    lite_stop stop;
+    // Only set by 'lite_memcpy_until_hash()': 'lite_memhash(src, len)'.
+    uint32_t hash;
+} lite_copy_result;
+
+// Copies 'src' up to its terminating '\0' or 'n' bytes, whichever comes first.
+LITE_INHEADER lite_copy_result lite_strcpy_measure(char *restrict dst, const char *restrict src, size_t n)
+{
+    size_t i = 0;
+    lite_stop stop = LITE_STOP_LIMIT;
+    for (; i < n; ++i) {
+        char c = src[i];
+        if (c == '\0') {
+            stop = LITE_STOP_NUL;
+            break;
+        }
+        dst[i] = c;
+        LITE_COMPILER_BARRIER();
+    }
+    return (lite_copy_result) {.end = dst + i, .len = i, .stop = stop, .hash = 0};
+}
+
+// Copies 'src[0..n)' up to the first byte that is in 'set'.
+LITE_INHEADER lite_copy_result lite_memcpy_until(
+        void *restrict dst, const void *restrict src, size_t n,
+        const lite_byteset *set)
+{
+    char *d = dst;
+    const char *s = src;
+    size_t i = 0;
+    lite_stop stop = LITE_STOP_LIMIT;
+    for (; i < n; ++i) {
+        char c = s[i];
+        if (lite_byteset_has(set, c)) {
+            stop = LITE_STOP_BYTE;
+            break;
+        }
+        d[i] = c;
+        LITE_COMPILER_BARRIER();
+    }
+    return (lite_copy_result) {.end = d + i, .len = i, .stop = stop, .hash = 0};
+}
+
+// Same as 'lite_memcpy_until()', but also hashes the copied bytes.
+LITE_INHEADER lite_copy_result lite_memcpy_until_hash(
+        void *restrict dst, const void *restrict src, size_t n,
+        const lite_byteset *set)
+{
+    char *d = dst;
+    const char *s = src;
+    uint32_t h = LITE_MEMHASH_INIT;
+    size_t i = 0;
+    lite_stop stop = LITE_STOP_LIMIT;
+    for (; i < n; ++i) {
+        char c = s[i];
+        if (lite_byteset_has(set, c)) {
+            stop = LITE_STOP_BYTE;
+            break;
+        }
+        d[i] = c;
+        h = lite_memhash_step(h, c);
+        LITE_COMPILER_BARRIER();
+    }
+    return (lite_copy_result) {.end = d + i, .len = i, .stop = stop, .hash = h};
+}
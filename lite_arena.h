@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "lite.h"
+
+// A bump allocator over a caller-supplied buffer.
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t used;
+} lite_arena;
+
+LITE_INHEADER void lite_arena_init(lite_arena *a, char *buf, size_t size)
+{
+    a->buf = buf;
+    a->size = size;
+    a->used = 0;
+}
+
+// Returns NULL if there is not enough room left.
+LITE_INHEADER void *lite_arena_alloc(lite_arena *a, size_t n)
+{
+    if (n > a->size - a->used) {
+        return NULL;
+    }
+    void *p = a->buf + a->used;
+    a->used += n;
+    return p;
+}
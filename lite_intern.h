@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "lite.h"
+#include "lite_arena.h"
+
+// A string interning table that stores each unique string once and maps it to a stable 32-bit ID.
+//
+// The table does not allocate: the caller supplies an array of slots (the number of slots must be
+// a nonzero power of two) and a buffer, used as a 'lite_arena'. Each string is stored in the arena
+// followed by '\0', and its ID is its offset in the arena, so 'lite_intern_str()' is a single
+// addition.
+//
+// Slots carry the hash and the length of the string inline, so probing only touches the arena for
+// a slot whose hash and length both match.
+//
+// After 'lite_intern_freeze()', neither 'lite_intern_find()' nor 'lite_intern_add()' writes to
+// the table, so any number of threads may call them concurrently. Until then, the table must only
+// be used by one thread at a time.
+
+#define LITE_INTERN_NONE UINT32_MAX
+
+typedef struct {
+    // '(hash << 32) | len'; zero means the slot is empty (the stored hash is never zero).
+    uint64_t tag;
+    uint32_t id;
+} lite_intern_slot;
+
+typedef struct {
+    lite_intern_slot *slots;
+    size_t mask;
+    size_t nused;
+    lite_arena arena;
+    bool frozen;
+} lite_intern;
+
+LITE_INHEADER void lite_intern_init(
+        lite_intern *t,
+        lite_intern_slot *slots, size_t nslots,
+        char *arena, size_t arena_size)
+{
+    lite_memset(slots, '\0', nslots * sizeof(lite_intern_slot));
+    t->slots = slots;
+    t->mask = nslots - 1;
+    t->nused = 0;
+    lite_arena_init(&t->arena, arena, arena_size);
+    t->frozen = false;
+}
+
+LITE_INHEADER uint64_t lite_intern__tag(const char *s, size_t n)
+{
+    uint32_t h = lite_memhash(s, n);
+    if (h == 0) {
+        h = 1;
+    }
+    return (((uint64_t) h) << 32) | (uint32_t) n;
+}
+
+// Returns the index of the slot holding 's', or of the empty slot where it would be inserted.
+LITE_INHEADER size_t lite_intern__probe(const lite_intern *t, const char *s, size_t n, uint64_t tag)
+{
+    size_t i = (tag >> 32) & t->mask;
+    for (;; i = (i + 1) & t->mask) {
+        const lite_intern_slot *slot = &t->slots[i];
+        if (slot->tag == 0) {
+            return i;
+        }
+        if (slot->tag == tag && lite_memcmp(t->arena.buf + slot->id, s, n) == 0) {
+            return i;
+        }
+        LITE_COMPILER_BARRIER();
+    }
+}
+
+// Returns the ID of 's' (of length 'n'), or 'LITE_INTERN_NONE' if it has not been interned.
+LITE_INHEADER uint32_t lite_intern_find(const lite_intern *t, const char *s, size_t n)
+{
+    if (n > UINT32_MAX) {
+        return LITE_INTERN_NONE;
+    }
+    const lite_intern_slot *slot = &t->slots[lite_intern__probe(t, s, n, lite_intern__tag(s, n))];
+    return slot->tag == 0 ? LITE_INTERN_NONE : slot->id;
+}
+
+// Returns the ID of 's' (of length 'n'), interning it first if needed.
+//
+// Returns 'LITE_INTERN_NONE' if 's' is not yet interned and either the table is frozen, the slots
+// are 3/4 full, or the arena has no room left for 'n + 1' bytes.
+LITE_INHEADER uint32_t lite_intern_add(lite_intern *t, const char *s, size_t n)
+{
+    if (n > UINT32_MAX) {
+        return LITE_INTERN_NONE;
+    }
+    // Read before probing: pairs with the release in 'lite_intern_freeze()', so that a thread that
+    // sees the table frozen also sees every string added before.
+    bool frozen = __atomic_load_n(&t->frozen, __ATOMIC_ACQUIRE);
+    uint64_t tag = lite_intern__tag(s, n);
+    lite_intern_slot *slot = &t->slots[lite_intern__probe(t, s, n, tag)];
+    if (slot->tag != 0) {
+        return slot->id;
+    }
+
+    if (frozen) {
+        return LITE_INTERN_NONE;
+    }
+    if ((t->nused + 1) * 4 > (t->mask + 1) * 3) {
+        return LITE_INTERN_NONE;
+    }
+    // IDs are arena offsets, which must stay below 'LITE_INTERN_NONE'.
+    uint32_t id = t->arena.used;
+    char *dst;
+    if (t->arena.used >= LITE_INTERN_NONE || (dst = lite_arena_alloc(&t->arena, n + 1)) == NULL) {
+        return LITE_INTERN_NONE;
+    }
+    lite_memcpy(dst, s, n);
+    dst[n] = '\0';
+
+    slot->tag = tag;
+    slot->id = id;
+    ++t->nused;
+    return id;
+}
+
+LITE_INHEADER void lite_intern_freeze(lite_intern *t)
+{
+    __atomic_store_n(&t->frozen, true, __ATOMIC_RELEASE);
+}
+
+// Returns the canonical, '\0'-terminated copy of the string with the given ID.
+LITE_INHEADER const char *lite_intern_str(const lite_intern *t, uint32_t id)
+{
+    return t->arena.buf + id;
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "lite.h"
+
+// A matcher that scans a haystack for any of a set of needles in one pass (Aho-Corasick).
+//
+// The automaton is a flat 'nstates * nclasses' transition table, where bytes that never occur in
+// any needle share a single class, so that a set of short needles needs only a few kilobytes. While the
+// automaton is in its initial state, bytes that no needle starts with are skipped using a bitmap.
+//
+// The matcher does not allocate: the caller supplies a buffer of at least
+// 'lite_multimatch_bufsize()' elements. Empty needles are not supported.
+
+typedef struct {
+    const uint16_t *delta;
+    const uint16_t *out;   // 1 + index of the needle that ends at this state, or 0
+    const uint16_t *dict;  // the nearest state on the failure chain with a nonzero 'out', or 0
+    const uint16_t *depth;
+    size_t nclasses;
+    lite_byteset first;
+    unsigned char cls[256];
+} lite_multimatch;
+
+typedef struct {
+    size_t i;
+    uint16_t state;
+    uint16_t pending;
+} lite_multimatch_iter;
+
+// Assigns byte classes and returns the maximum number of states. Each byte that occurs in some
+// needle gets its own class; all the others (if any) share the last one.
+LITE_INHEADER size_t lite_multimatch__limits(
+        const char *const *needles, const size_t *lens, size_t nneedles,
+        unsigned char *cls, size_t *nclasses)
+{
+    bool seen[256];
+    lite_memset(seen, '\0', sizeof(seen));
+    size_t ncls = 0;
+    size_t nstates = 1;
+    for (size_t k = 0; k < nneedles; ++k) {
+        const unsigned char *s = (const unsigned char *) needles[k];
+        for (size_t j = 0; j < lens[k]; ++j) {
+            if (!seen[s[j]]) {
+                seen[s[j]] = true;
+                cls[s[j]] = ncls++;
+            }
+            LITE_COMPILER_BARRIER();
+        }
+        nstates += lens[k];
+    }
+    if (ncls < 256) {
+        for (size_t c = 0; c < 256; ++c) {
+            if (!seen[c]) {
+                cls[c] = ncls;
+            }
+            LITE_COMPILER_BARRIER();
+        }
+        ++ncls;
+    }
+    *nclasses = ncls;
+    return nstates;
+}
+
+LITE_INHEADER size_t lite_multimatch_bufsize(const char *const *needles, const size_t *lens, size_t nneedles)
+{
+    unsigned char cls[256];
+    size_t nclasses;
+    size_t nstates = lite_multimatch__limits(needles, lens, nneedles, cls, &nclasses);
+    return nstates * (nclasses + 5);
+}
+
+// Returns false if some needle is empty, if there are more than 65534 needles or too many states
+// in total, or if 'nbuf' is less than 'lite_multimatch_bufsize()'.
+LITE_INHEADER bool lite_multimatch_compile(
+        lite_multimatch *mm,
+        const char *const *needles, const size_t *lens, size_t nneedles,
+        uint16_t *buf, size_t nbuf)
+{
+    size_t ncls;
+    size_t maxstates = lite_multimatch__limits(needles, lens, nneedles, mm->cls, &ncls);
+    if (nneedles > UINT16_MAX - 1 || maxstates > UINT16_MAX || nbuf < maxstates * (ncls + 5)) {
+        return false;
+    }
+
+    uint16_t *delta = buf;
+    uint16_t *out = delta + maxstates * ncls;
+    uint16_t *dict = out + maxstates;
+    uint16_t *depth = dict + maxstates;
+    uint16_t *fail = depth + maxstates;
+    uint16_t *queue = fail + maxstates;
+
+    // Build the trie. Zero in 'delta' means "no child", which is unambiguous since the root is
+    // never a child.
+    lite_memset(&mm->first, '\0', sizeof(mm->first));
+    lite_memset(delta, '\0', ncls * sizeof(uint16_t));
+    out[0] = 0;
+    depth[0] = 0;
+    size_t nstates = 1;
+    for (size_t k = 0; k < nneedles; ++k) {
+        const unsigned char *s = (const unsigned char *) needles[k];
+        if (lens[k] == 0) {
+            return false;
+        }
+        lite_byteset_add(&mm->first, s[0]);
+        size_t state = 0;
+        for (size_t j = 0; j < lens[k]; ++j) {
+            uint16_t *t = &delta[state * ncls + mm->cls[s[j]]];
+            if (!*t) {
+                lite_memset(&delta[nstates * ncls], '\0', ncls * sizeof(uint16_t));
+                out[nstates] = 0;
+                depth[nstates] = depth[state] + 1;
+                *t = nstates++;
+            }
+            state = *t;
+            LITE_COMPILER_BARRIER();
+        }
+        if (!out[state]) {
+            out[state] = k + 1;
+        }
+    }
+
+    // Compute failure links in BFS order and turn the trie into a full transition table. A state
+    // is a child of 's' (rather than the target of a failure transition) if and only if it is one
+    // level deeper.
+    size_t head = 0;
+    size_t tail = 0;
+    fail[0] = 0;
+    dict[0] = 0;
+    queue[tail++] = 0;
+    while (head != tail) {
+        size_t s = queue[head++];
+        uint16_t *row = &delta[s * ncls];
+        const uint16_t *frow = &delta[fail[s] * ncls];
+        for (size_t c = 0; c < ncls; ++c) {
+            size_t t = row[c];
+            if (t && depth[t] == depth[s] + 1) {
+                size_t f = s ? frow[c] : 0;
+                fail[t] = f;
+                dict[t] = out[f] ? f : dict[f];
+                queue[tail++] = t;
+            } else {
+                row[c] = s ? frow[c] : 0;
+            }
+            LITE_COMPILER_BARRIER();
+        }
+    }
+
+    mm->delta = delta;
+    mm->out = out;
+    mm->dict = dict;
+    mm->depth = depth;
+    mm->nclasses = ncls;
+    return true;
+}
+
+LITE_INHEADER void lite_multimatch_iter_init(lite_multimatch_iter *it)
+{
+    it->i = 0;
+    it->state = 0;
+    it->pending = 0;
+}
+
+// Reports the next match, in the order of their end positions (and, for matches that end at the
+// same position, longest first). Sets '*pos' to the offset of the start of the match and '*which'
+// to the index of the needle. Returns false when there are no more matches.
+LITE_INHEADER bool lite_multimatch_next(
+        const lite_multimatch *mm, lite_multimatch_iter *it,
+        const void *haystack, size_t nhaystack,
+        size_t *pos, size_t *which)
+{
+    const unsigned char *h = haystack;
+    size_t i = it->i;
+    size_t state = it->state;
+    size_t pending = it->pending;
+    for (;;) {
+        if (pending) {
+            *pos = i - mm->depth[pending];
+            *which = mm->out[pending] - 1;
+            it->i = i;
+            it->state = state;
+            it->pending = mm->dict[pending];
+            return true;
+        }
+        if (state == 0) {
+            while (i != nhaystack && !lite_byteset_has(&mm->first, h[i])) {
+                ++i;
+                LITE_COMPILER_BARRIER();
+            }
+        }
+        if (i == nhaystack) {
+            it->i = i;
+            it->state = state;
+            it->pending = 0;
+            return false;
+        }
+        state = mm->delta[state * mm->nclasses + mm->cls[h[i++]]];
+        pending = mm->out[state] ? state : mm->dict[state];
+        LITE_COMPILER_BARRIER();
+    }
+}
+
+// Returns a pointer to the start of the match that ends first, or NULL if there is none. If
+// 'which' is not NULL, sets '*which' to the index of the needle.
+LITE_INHEADER void *lite_multimatch_find(
+        const lite_multimatch *mm,
+        const void *haystack, size_t nhaystack,
+        size_t *which)
+{
+    lite_multimatch_iter it;
+    lite_multimatch_iter_init(&it);
+    size_t pos;
+    size_t w;
+    if (!lite_multimatch_next(mm, &it, haystack, nhaystack, &pos, &w)) {
+        return NULL;
+    }
+    if (which) {
+        *which = w;
+    }
+    return ((char *) haystack) + pos;
+}
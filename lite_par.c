@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+
+#include "lite_par.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Within a chunk, glibc's 'memchr()'/'memmem()' are used: chunks are far from the N ≈ 0 that
+// 'lite.h' is designed for.
+
+struct lite_par_pool {
+    // Serializes searches.
+    pthread_mutex_t call_mtx;
+
+    pthread_mutex_t mtx;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    pthread_t *threads;
+    size_t nthreads;
+    // Incremented for every search; workers wait for it to change.
+    uint64_t generation;
+    // The number of workers that have not yet finished the current search.
+    size_t nbusy;
+    bool stop;
+
+    // The current search.
+    const char *haystack;
+    const char *needle;
+    size_t nneedle;
+    size_t npos;
+    size_t nchunks;
+    // Accessed atomically.
+    size_t next_chunk;
+    size_t best;
+};
+
+static void update_best(lite_par_pool *pool, size_t pos)
+{
+    size_t cur = __atomic_load_n(&pool->best, __ATOMIC_RELAXED);
+    while (pos < cur) {
+        if (__atomic_compare_exchange_n(&pool->best, &cur, pos, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+}
+
+static void run_chunks(lite_par_pool *pool)
+{
+    for (;;) {
+        size_t k = __atomic_fetch_add(&pool->next_chunk, 1, __ATOMIC_RELAXED);
+        if (k >= pool->nchunks) {
+            return;
+        }
+        size_t start = k * LITE_PAR_CHUNK;
+        // Chunks are taken in increasing order, so all the remaining ones start even later.
+        if (start >= __atomic_load_n(&pool->best, __ATOMIC_RELAXED)) {
+            return;
+        }
+        size_t npos = pool->npos - start < LITE_PAR_CHUNK ? pool->npos - start : LITE_PAR_CHUNK;
+        const char *p = pool->haystack + start;
+        const char *found;
+        if (pool->nneedle == 1) {
+            found = memchr(p, pool->needle[0], npos);
+        } else {
+            found = memmem(p, npos + pool->nneedle - 1, pool->needle, pool->nneedle);
+        }
+        if (found) {
+            update_best(pool, found - pool->haystack);
+        }
+    }
+}
+
+static void *worker(void *arg)
+{
+    lite_par_pool *pool = arg;
+    uint64_t seen = 0;
+    pthread_mutex_lock(&pool->mtx);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->work_cond, &pool->mtx);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mtx);
+
+        run_chunks(pool);
+
+        pthread_mutex_lock(&pool->mtx);
+        if (--pool->nbusy == 0) {
+            pthread_cond_signal(&pool->done_cond);
+        }
+    }
+    pthread_mutex_unlock(&pool->mtx);
+    return NULL;
+}
+
+lite_par_pool *lite_par_pool_new(size_t nthreads)
+{
+    lite_par_pool *pool = calloc(1, sizeof(lite_par_pool));
+    if (!pool) {
+        return NULL;
+    }
+    pool->threads = calloc(nthreads ? nthreads : 1, sizeof(pthread_t));
+    if (!pool->threads) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->call_mtx, NULL);
+    pthread_mutex_init(&pool->mtx, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    for (; pool->nthreads < nthreads; ++pool->nthreads) {
+        if (pthread_create(&pool->threads[pool->nthreads], NULL, worker, pool) != 0) {
+            lite_par_pool_free(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void lite_par_pool_free(lite_par_pool *pool)
+{
+    if (!pool) {
+        return;
+    }
+    pthread_mutex_lock(&pool->mtx);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mtx);
+    for (size_t i = 0; i < pool->nthreads; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->mtx);
+    pthread_mutex_destroy(&pool->call_mtx);
+    free(pool->threads);
+    free(pool);
+}
+
+static void *search(lite_par_pool *pool, const char *haystack, size_t nhaystack, const char *needle, size_t nneedle)
+{
+    if (nneedle > nhaystack) {
+        return NULL;
+    }
+    if (nneedle == 0) {
+        return (void *) haystack;
+    }
+    if (nhaystack < LITE_PAR_MIN || pool->nthreads == 0) {
+        if (nneedle == 1) {
+            return memchr(haystack, needle[0], nhaystack);
+        }
+        return memmem(haystack, nhaystack, needle, nneedle);
+    }
+
+    pthread_mutex_lock(&pool->call_mtx);
+
+    pthread_mutex_lock(&pool->mtx);
+    pool->haystack = haystack;
+    pool->needle = needle;
+    pool->nneedle = nneedle;
+    pool->npos = nhaystack - nneedle + 1;
+    pool->nchunks = (pool->npos + LITE_PAR_CHUNK - 1) / LITE_PAR_CHUNK;
+    pool->next_chunk = 0;
+    pool->best = SIZE_MAX;
+    pool->nbusy = pool->nthreads;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mtx);
+
+    run_chunks(pool);
+
+    pthread_mutex_lock(&pool->mtx);
+    while (pool->nbusy) {
+        pthread_cond_wait(&pool->done_cond, &pool->mtx);
+    }
+    size_t best = pool->best;
+    pthread_mutex_unlock(&pool->mtx);
+
+    pthread_mutex_unlock(&pool->call_mtx);
+
+    return best == SIZE_MAX ? NULL : (void *) (haystack + best);
+}
+
+void *lite_par_memchr(lite_par_pool *pool, const void *p, char c, size_t n)
+{
+    return search(pool, p, n, &c, 1);
+}
+
+void *lite_par_memmem(lite_par_pool *pool, const void *haystack, size_t nhaystack, const void *needle, size_t nneedle)
+{
+    return search(pool, haystack, nhaystack, needle, nneedle);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+
+// Multi-threaded 'memchr()'/'memmem()' for large buffers (such as mmap'd files), in a separately
+// compiled module ('lite_par.c', linked with '-pthread').
+//
+// The range is split into chunks of 'LITE_PAR_CHUNK' possible match positions, which the threads of
+// a pool (and the calling thread) take in increasing order. Each chunk is searched together with
+// the 'nneedle - 1' bytes that follow it, so matches that straddle a chunk boundary are found. Once
+// a match is found, chunks that start after it are skipped, and the leftmost match is returned.
+//
+// Inputs shorter than 'LITE_PAR_MIN' bytes are searched by the calling thread alone.
+
+#define LITE_PAR_CHUNK ((size_t) 256 * 1024)
+#define LITE_PAR_MIN ((size_t) 1024 * 1024)
+
+typedef struct lite_par_pool lite_par_pool;
+
+// Starts 'nthreads' worker threads (which may be zero). Returns NULL on failure.
+lite_par_pool *lite_par_pool_new(size_t nthreads);
+
+void lite_par_pool_free(lite_par_pool *pool);
+
+// A pool runs one search at a time; concurrent calls on the same pool are serialized.
+void *lite_par_memchr(lite_par_pool *pool, const void *p, char c, size_t n);
+
+void *lite_par_memmem(lite_par_pool *pool, const void *haystack, size_t nhaystack, const void *needle, size_t nneedle);
@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// An LD_PRELOAD library that replaces some of the <string.h> functions with dispatchers: calls
+// whose size is below a threshold go to the 'lite_*' loop, the rest go to the next definition of
+// the symbol (normally glibc's). For functions on '\0'-terminated strings, whose size is not known
+// up front, the first 'threshold' bytes are handled by 'lite_*' and the rest, if any, by glibc.
+//
+// Build with 'make liblite_preload.so' and run with
+//
+//     LD_PRELOAD=./liblite_preload.so LITE_PRELOAD_REPORT=1 ./program
+//
+// Environment variables:
+//   * 'LITE_PRELOAD_THRESHOLD' overrides the threshold of every function;
+//   * if 'LITE_PRELOAD_REPORT' is set, per-function counters of calls and bytes, split by which
+//     implementation handled them, are kept and written to stderr at exit; otherwise, nothing is
+//     counted.
+//
+// Bytes are the size argument, or the length of the string. The exceptions are 'strcmp()' and
+// 'strchr()': when they go to glibc, finding the length would take an extra pass, so only the
+// first 'threshold' bytes are counted. Their libc byte counts are thus lower bounds.
+
+#define _GNU_SOURCE
+
+#include "lite.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+enum {
+    SYM_MEMCPY,
+    SYM_MEMMOVE,
+    SYM_MEMSET,
+    SYM_MEMCMP,
+    SYM_MEMCHR,
+    SYM_STRLEN,
+    SYM_STRNLEN,
+    SYM_STRCMP,
+    SYM_STRNCMP,
+    SYM_STRCHR,
+    SYM_STRCPY,
+    SYM_STPCPY,
+    NSYMS,
+};
+
+typedef struct {
+    const char *name;
+    size_t threshold;
+    // NULL until resolved; until then, everything goes to 'lite_*'.
+    void *real;
+    // If set, 'libc_bytes' counts only the first 'threshold' bytes of each call.
+    bool libc_bytes_capped;
+} lite_preload_sym;
+
+static lite_preload_sym syms[NSYMS] = {
+    [SYM_MEMCPY]  = {.name = "memcpy",  .threshold = 64},
+    [SYM_MEMMOVE] = {.name = "memmove", .threshold = 64},
+    [SYM_MEMSET]  = {.name = "memset",  .threshold = 64},
+    [SYM_MEMCMP]  = {.name = "memcmp",  .threshold = 32},
+    [SYM_MEMCHR]  = {.name = "memchr",  .threshold = 32},
+    [SYM_STRLEN]  = {.name = "strlen",  .threshold = 32},
+    [SYM_STRNLEN] = {.name = "strnlen", .threshold = 32},
+    [SYM_STRCMP]  = {.name = "strcmp",  .threshold = 32, .libc_bytes_capped = true},
+    [SYM_STRNCMP] = {.name = "strncmp", .threshold = 32},
+    [SYM_STRCHR]  = {.name = "strchr",  .threshold = 32, .libc_bytes_capped = true},
+    [SYM_STRCPY]  = {.name = "strcpy",  .threshold = 64},
+    [SYM_STPCPY]  = {.name = "stpcpy",  .threshold = 64},
+};
+
+typedef struct {
+    uint64_t lite_calls;
+    uint64_t lite_bytes;
+    uint64_t libc_calls;
+    uint64_t libc_bytes;
+} lite_preload_counters;
+
+// Counters are kept per thread, so that counting does not make all threads contend for the same
+// cache lines. The blocks come from a fixed pool (the preload library cannot call 'malloc()',
+// which may call the functions it intercepts), and are not reused when threads exit; threads
+// beyond the first 'MAX_BLOCKS' share 'overflow_block', which is updated with atomic adds.
+#define MAX_BLOCKS 256
+
+typedef struct {
+    lite_preload_counters counters[NSYMS];
+} __attribute__((aligned(64))) lite_preload_block;
+
+static lite_preload_block blocks[MAX_BLOCKS];
+static size_t nblocks;
+static lite_preload_block overflow_block;
+
+// NULL until the thread first counts something.
+static __thread lite_preload_block *thread_block __attribute__((tls_model("initial-exec")));
+
+// Counting is enabled only if 'LITE_PRELOAD_REPORT' is set, so that the A/B comparison this
+// library is for is not skewed by it.
+static bool counting;
+
+static void count(const lite_preload_sym *sym, bool lite, size_t nbytes)
+{
+    if (!counting) {
+        return;
+    }
+    lite_preload_block *b = thread_block;
+    if (!b) {
+        size_t k = __atomic_fetch_add(&nblocks, 1, __ATOMIC_RELAXED);
+        b = k < MAX_BLOCKS ? &blocks[k] : &overflow_block;
+        thread_block = b;
+    }
+    lite_preload_counters *c = &b->counters[sym - syms];
+    uint64_t *calls = lite ? &c->lite_calls : &c->libc_calls;
+    uint64_t *bytes = lite ? &c->lite_bytes : &c->libc_bytes;
+    if (b == &overflow_block) {
+        __atomic_fetch_add(calls, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(bytes, nbytes, __ATOMIC_RELAXED);
+    } else {
+        // Only the owning thread writes; the stores are atomic only so that the report, which
+        // may run while other threads are still going, reads untorn values.
+        __atomic_store_n(calls, __atomic_load_n(calls, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(bytes, __atomic_load_n(bytes, __ATOMIC_RELAXED) + nbytes, __ATOMIC_RELAXED);
+    }
+}
+
+static void add_block(lite_preload_counters *out, const lite_preload_block *b)
+{
+    for (size_t i = 0; i < NSYMS; ++i) {
+        const lite_preload_counters *c = &b->counters[i];
+        out[i].lite_calls += __atomic_load_n(&c->lite_calls, __ATOMIC_RELAXED);
+        out[i].lite_bytes += __atomic_load_n(&c->lite_bytes, __ATOMIC_RELAXED);
+        out[i].libc_calls += __atomic_load_n(&c->libc_calls, __ATOMIC_RELAXED);
+        out[i].libc_bytes += __atomic_load_n(&c->libc_bytes, __ATOMIC_RELAXED);
+    }
+}
+
+__attribute__((constructor))
+static void init(void)
+{
+    counting = getenv("LITE_PRELOAD_REPORT") != NULL;
+    const char *threshold = getenv("LITE_PRELOAD_THRESHOLD");
+    uint64_t value;
+    if (threshold && lite_parse_u64(threshold, lite_strlen(threshold), &value)) {
+        for (size_t i = 0; i < NSYMS; ++i) {
+            syms[i].threshold = value;
+        }
+    }
+    for (size_t i = 0; i < NSYMS; ++i) {
+        syms[i].real = dlsym(RTLD_NEXT, syms[i].name);
+    }
+}
+
+__attribute__((destructor))
+static void report(void)
+{
+    if (!counting) {
+        return;
+    }
+    lite_preload_counters totals[NSYMS] = {0};
+    size_t n = __atomic_load_n(&nblocks, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < n && i < MAX_BLOCKS; ++i) {
+        add_block(totals, &blocks[i]);
+    }
+    add_block(totals, &overflow_block);
+
+    fprintf(stderr, "liblite_preload counters for pid %ld:\n", (long) getpid());
+    fprintf(stderr, "%-8s %9s %14s %14s %14s %14s\n",
+            "function", "threshold", "lite calls", "lite bytes", "libc calls", "libc bytes");
+    for (size_t i = 0; i < NSYMS; ++i) {
+        const lite_preload_counters *c = &totals[i];
+        fprintf(stderr, "%-8s %9zu %14llu %14llu %14llu %14llu\n",
+                syms[i].name, syms[i].threshold,
+                (unsigned long long) c->lite_calls, (unsigned long long) c->lite_bytes,
+                (unsigned long long) c->libc_calls, (unsigned long long) c->libc_bytes);
+    }
+    for (size_t i = 0; i < NSYMS; ++i) {
+        if (syms[i].libc_bytes_capped) {
+            fprintf(stderr, "%s: libc bytes are a lower bound (only the first 'threshold' bytes of each call)\n",
+                    syms[i].name);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void *memcpy(void *dst, const void *src, size_t n)
+{
+    lite_preload_sym *sym = &syms[SYM_MEMCPY];
+    void *(*real)(void *, const void *, size_t) = sym->real;
+    if (n < sym->threshold || !real) {
+        count(sym, true, n);
+        return lite_memcpy(dst, src, n);
+    }
+    count(sym, false, n);
+    return real(dst, src, n);
+}
+
+void *memmove(void *dst, const void *src, size_t n)
+{
+    lite_preload_sym *sym = &syms[SYM_MEMMOVE];
+    void *(*real)(void *, const void *, size_t) = sym->real;
+    if (n < sym->threshold || !real) {
+        count(sym, true, n);
+        return lite_memmove(dst, src, n);
+    }
+    count(sym, false, n);
+    return real(dst, src, n);
+}
+
+void *memset(void *p, int c, size_t n)
+{
+    lite_preload_sym *sym = &syms[SYM_MEMSET];
+    void *(*real)(void *, int, size_t) = sym->real;
+    if (n < sym->threshold || !real) {
+        count(sym, true, n);
+        return lite_memset(p, c, n);
+    }
+    count(sym, false, n);
+    return real(p, c, n);
+}
+
+int memcmp(const void *p, const void *q, size_t n)
+{
+    lite_preload_sym *sym = &syms[SYM_MEMCMP];
+    int (*real)(const void *, const void *, size_t) = sym->real;
+    if (n < sym->threshold || !real) {
+        count(sym, true, n);
+        return lite_memcmp(p, q, n);
+    }
+    count(sym, false, n);
+    return real(p, q, n);
+}
+
+void *memchr(const void *p, int c, size_t n)
+{
+    lite_preload_sym *sym = &syms[SYM_MEMCHR];
+    void *(*real)(const void *, int, size_t) = sym->real;
+    if (n < sym->threshold || !real) {
+        count(sym, true, n);
+        return lite_memchr(p, c, n);
+    }
+    count(sym, false, n);
+    return real(p, c, n);
+}
+
+size_t strnlen(const char *s, size_t n)
+{
+    lite_preload_sym *sym = &syms[SYM_STRNLEN];
+    size_t (*real)(const char *, size_t) = sym->real;
+    size_t ret;
+    bool lite = n < sym->threshold || !real;
+    if (lite) {
+        ret = lite_strnlen(s, n);
+    } else {
+        ret = real(s, n);
+    }
+    count(sym, lite, ret);
+    return ret;
+}
+
+int strncmp(const char *p, const char *q, size_t n)
+{
+    lite_preload_sym *sym = &syms[SYM_STRNCMP];
+    int (*real)(const char *, const char *, size_t) = sym->real;
+    if (n < sym->threshold || !real) {
+        count(sym, true, n);
+        return lite_strncmp(p, q, n);
+    }
+    count(sym, false, n);
+    return real(p, q, n);
+}
+
+size_t strlen(const char *s)
+{
+    lite_preload_sym *sym = &syms[SYM_STRLEN];
+    size_t (*real)(const char *) = sym->real;
+    size_t n = lite_strnlen(s, sym->threshold);
+    if (n < sym->threshold || !real) {
+        n += lite_strlen(s + n);
+        count(sym, true, n);
+        return n;
+    }
+    n += real(s + n);
+    count(sym, false, n);
+    return n;
+}
+
+int strcmp(const char *p, const char *q)
+{
+    lite_preload_sym *sym = &syms[SYM_STRCMP];
+    int (*real)(const char *, const char *) = sym->real;
+    size_t n = lite_strnlen(p, sym->threshold);
+    int ret = lite_strncmp(p, q, n + 1);
+    if (ret != 0 || n < sym->threshold || !real) {
+        if (ret == 0 && n == sym->threshold) {
+            ret = lite_strcmp(p + n, q + n);
+        }
+        count(sym, true, n);
+        return ret;
+    }
+    count(sym, false, n);
+    return real(p + n, q + n);
+}
+
+char *strchr(const char *s, int c)
+{
+    lite_preload_sym *sym = &syms[SYM_STRCHR];
+    char *(*real)(const char *, int) = sym->real;
+    size_t n = lite_strnlen(s, sym->threshold);
+    // If the string ends within the threshold, include the '\0', which 'strchr()' can find too.
+    char *ret = lite_memchr(s, c, n < sym->threshold ? n + 1 : n);
+    if (ret || n < sym->threshold || !real) {
+        if (!ret && n == sym->threshold) {
+            ret = lite_strchr(s + n, c);
+        }
+        count(sym, true, n);
+        return ret;
+    }
+    count(sym, false, n);
+    return real(s + n, c);
+}
+
+char *stpcpy(char *dst, const char *src)
+{
+    lite_preload_sym *sym = &syms[SYM_STPCPY];
+    char *(*real)(char *, const char *) = sym->real;
+    size_t n = lite_strnlen(src, sym->threshold);
+    if (n < sym->threshold || !real) {
+        char *ret = lite_stpcpy(dst, src);
+        count(sym, true, ret - dst);
+        return ret;
+    }
+    lite_memcpy(dst, src, n);
+    char *ret = real(dst + n, src + n);
+    count(sym, false, ret - dst);
+    return ret;
+}
+
+char *strcpy(char *dst, const char *src)
+{
+    lite_preload_sym *sym = &syms[SYM_STRCPY];
+    char *(*real)(char *, const char *) = sym->real;
+    size_t n = lite_strnlen(src, sym->threshold);
+    if (n < sym->threshold || !real) {
+        char *end = lite_stpcpy(dst, src);
+        count(sym, true, end - dst);
+        return dst;
+    }
+    lite_memcpy(dst, src, n);
+    // 'stpcpy()' returns the end, so the whole length can be counted without another pass.
+    char *(*real_stpcpy)(char *, const char *) = syms[SYM_STPCPY].real;
+    char *end;
+    if (real_stpcpy) {
+        end = real_stpcpy(dst + n, src + n);
+    } else {
+        real(dst + n, src + n);
+        end = dst + n + lite_strlen(dst + n);
+    }
+    count(sym, false, end - dst);
+    return dst;
+}
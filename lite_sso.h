@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "lite.h"
+#include "lite_arena.h"
+
+// A 16-byte string value.
+//
+// Strings of up to 'LITE_SSO_MAXINLINE' bytes are stored inline: 'bytes[0..len)' hold the data,
+// the rest of 'bytes[0..15)' is zero, and 'bytes[15]' holds the length. Longer strings are copied
+// into an arena, and 'bytes[15]' is set to 'LITE_SSO_SPILLED'.
+//
+// The representation is canonical, so two inline strings are equal if and only if both their words
+// are, and they compare in the same order as their big-endian words do.
+
+#define LITE_SSO_MAXINLINE 15
+#define LITE_SSO_SPILLED 0xFF
+
+typedef union {
+    uint64_t words[2];
+    unsigned char bytes[16];
+    struct {
+        const char *ptr;
+        uint32_t len;
+    } ext;
+} lite_sso;
+
+_Static_assert(sizeof(lite_sso) == 16, "unexpected lite_sso size");
+
+LITE_INHEADER bool lite_sso_is_inline(const lite_sso *s)
+{
+    return s->bytes[15] != LITE_SSO_SPILLED;
+}
+
+LITE_INHEADER size_t lite_sso_len(const lite_sso *s)
+{
+    return lite_sso_is_inline(s) ? s->bytes[15] : s->ext.len;
+}
+
+// Note that the data is not '\0'-terminated.
+LITE_INHEADER const char *lite_sso_data(const lite_sso *s)
+{
+    return lite_sso_is_inline(s) ? (const char *) s->bytes : s->ext.ptr;
+}
+
+// Returns false if the string does not fit inline and there is not enough room left in 'a' ('a'
+// may be NULL if 'n' is known to be small). 's' is left empty in that case.
+LITE_INHEADER bool lite_sso_set(lite_sso *s, const char *p, size_t n, lite_arena *a)
+{
+    s->words[0] = 0;
+    s->words[1] = 0;
+    if (n <= LITE_SSO_MAXINLINE) {
+        lite_memcpy(s->bytes, p, n);
+        s->bytes[15] = n;
+        return true;
+    }
+    char *dst;
+    if (n > UINT32_MAX || !a || (dst = lite_arena_alloc(a, n)) == NULL) {
+        return false;
+    }
+    lite_memcpy(dst, p, n);
+    s->ext.ptr = dst;
+    s->ext.len = n;
+    s->bytes[15] = LITE_SSO_SPILLED;
+    return true;
+}
+
+LITE_INHEADER bool lite_sso_eq(const lite_sso *a, const lite_sso *b)
+{
+    if (a->words[0] == b->words[0] && a->words[1] == b->words[1]) {
+        return true;
+    }
+    if (lite_sso_is_inline(a) || lite_sso_is_inline(b)) {
+        return false;
+    }
+    return a->ext.len == b->ext.len && lite_memcmp(a->ext.ptr, b->ext.ptr, a->ext.len) == 0;
+}
+
+LITE_INHEADER int lite_sso_cmp(const lite_sso *a, const lite_sso *b)
+{
+    if (lite_sso_is_inline(a) && lite_sso_is_inline(b)) {
+        uint64_t a0 = lite_htobe64(a->words[0]);
+        uint64_t b0 = lite_htobe64(b->words[0]);
+        if (a0 != b0) {
+            return a0 < b0 ? -1 : 1;
+        }
+        uint64_t a1 = lite_htobe64(a->words[1]);
+        uint64_t b1 = lite_htobe64(b->words[1]);
+        if (a1 != b1) {
+            return a1 < b1 ? -1 : 1;
+        }
+        return 0;
+    }
+    size_t na = lite_sso_len(a);
+    size_t nb = lite_sso_len(b);
+    int ret = lite_memcmp(lite_sso_data(a), lite_sso_data(b), na < nb ? na : nb);
+    if (ret != 0) {
+        return ret;
+    }
+    return na == nb ? 0 : (na < nb ? -1 : 1);
+}
+
+LITE_INHEADER uint32_t lite_sso_hash(const lite_sso *s)
+{
+    if (!lite_sso_is_inline(s)) {
+        return lite_memhash(s->ext.ptr, s->ext.len);
+    }
+    uint64_t h = (s->words[0] ^ ((s->words[1] << 32) | (s->words[1] >> 32))) * 0x9E3779B97F4A7C15u;
+    return h >> 32;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lite_stats.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+__thread lite_stats__block *lite_stats__tls;
+
+// All blocks ever allocated, newest first. Only ever pushed to.
+static lite_stats__block *blocks;
+
+// Used when allocating a block fails; updates from different threads may then be lost.
+static lite_stats__block fallback_block;
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t key;
+
+static const char *const names[LITE_STATS_NFUNCS] = {
+#define LITE_STATS__NAME(Fn_) [LITE_STATS_ID_##Fn_] = #Fn_,
+    LITE_STATS_FUNCS(LITE_STATS__NAME)
+#undef LITE_STATS__NAME
+};
+
+static void release_block(void *arg)
+{
+    lite_stats__block *b = arg;
+    __atomic_store_n(&b->owned, 0, __ATOMIC_RELEASE);
+}
+
+static void make_key(void)
+{
+    if (pthread_key_create(&key, release_block) != 0) {
+        abort();
+    }
+}
+
+static lite_stats__block *acquire_block(void)
+{
+    lite_stats__block *b = __atomic_load_n(&blocks, __ATOMIC_ACQUIRE);
+    for (; b; b = b->next) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&b->owned, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return b;
+        }
+    }
+
+    void *mem;
+    if (posix_memalign(&mem, 64, sizeof(lite_stats__block)) != 0) {
+        return NULL;
+    }
+    b = mem;
+    memset(b, 0, sizeof(*b));
+    b->owned = 1;
+    b->next = __atomic_load_n(&blocks, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&blocks, &b->next, b, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    return b;
+}
+
+lite_stats__block *lite_stats__attach(void)
+{
+    pthread_once(&key_once, make_key);
+    lite_stats__block *b = acquire_block();
+    if (b) {
+        // If this fails, the block is never handed over to another thread, but is still counted.
+        (void) pthread_setspecific(key, b);
+    } else {
+        b = &fallback_block;
+    }
+    lite_stats__tls = b;
+    return b;
+}
+
+const char *lite_stats_name(size_t id)
+{
+    return id < LITE_STATS_NFUNCS ? names[id] : NULL;
+}
+
+static void add_block(lite_stats_counters *out, const lite_stats__block *b)
+{
+    for (size_t i = 0; i < LITE_STATS_NFUNCS; ++i) {
+        const lite_stats_counters *c = &b->slots[i].c;
+        out[i].calls += __atomic_load_n(&c->calls, __ATOMIC_RELAXED);
+        out[i].bytes += __atomic_load_n(&c->bytes, __ATOMIC_RELAXED);
+        out[i].cycles += __atomic_load_n(&c->cycles, __ATOMIC_RELAXED);
+    }
+}
+
+void lite_stats_snapshot(lite_stats_counters out[LITE_STATS_NFUNCS])
+{
+    memset(out, 0, sizeof(lite_stats_counters) * LITE_STATS_NFUNCS);
+    for (lite_stats__block *b = __atomic_load_n(&blocks, __ATOMIC_ACQUIRE); b; b = b->next) {
+        add_block(out, b);
+    }
+    add_block(out, &fallback_block);
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Opt-in counters for the most common 'lite.h' functions: compile with '-DLITE_STATS' and link
+// with 'lite_stats.c' (and '-pthread'). Without 'LITE_STATS', the hooks in 'lite.h' expand to
+// nothing.
+//
+// For every function listed in 'LITE_STATS_FUNCS', the number of calls, the number of bytes (the
+// size argument; for 'lite_strlen()', 'lite_strcpy()', 'lite_stpcpy()' and 'lite_strcmp()', the
+// number of bytes looked at; zero for 'lite_strchr()' and 'lite_strstr()') and a coarse cycle
+// count (from the time stamp counter, so it includes the cost of the hook itself; zero on
+// architectures other than x86 and AArch64) are kept.
+// Calls that 'lite_*' functions make to each other (e.g. 'lite_memmem()' to 'lite_memcmp()') are
+// counted too.
+//
+// Each thread gets its own block of counters, one cache line per function, that only it writes,
+// so counting takes no atomic read-modify-write instructions and no cache line bouncing. The
+// blocks are never freed: when a thread exits, its block, with its counts, is handed over to the
+// next new thread. 'lite_stats_snapshot()' sums all the blocks without stopping anyone, so the
+// result is not an atomic snapshot of all counters, but every counter in it is a value that
+// counter actually had. There is no reset; subtract two snapshots instead.
+//
+// If, in addition, 'LITE_STATS_USDT' is defined, every call also hits a USDT probe
+// 'liblite:<function>' (with the byte count as its argument, where known up front) from
+// <sys/sdt.h> (systemtap-sdt-dev or similar), which 'perf probe' or bpftrace can attach to at run
+// time; when nothing is attached, a probe is a single 'nop'. Defining 'LITE_STATS_USDT' where
+// <sys/sdt.h> is not available is an error.
+
+#define LITE_STATS_FUNCS(X) \
+    X(memcpy) \
+    X(memmove) \
+    X(memset) \
+    X(memcmp) \
+    X(memchr) \
+    X(memmem) \
+    X(strlen) \
+    X(strnlen) \
+    X(strcmp) \
+    X(strncmp) \
+    X(strchr) \
+    X(strstr) \
+    X(strcpy) \
+    X(stpcpy)
+
+enum {
+#define LITE_STATS__ENUM(Fn_) LITE_STATS_ID_##Fn_,
+    LITE_STATS_FUNCS(LITE_STATS__ENUM)
+#undef LITE_STATS__ENUM
+    LITE_STATS_NFUNCS,
+};
+
+typedef struct {
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t cycles;
+} lite_stats_counters;
+
+// Returns the name of the function with ID 'LITE_STATS_ID_<name>', without the 'lite_' prefix.
+const char *lite_stats_name(size_t id);
+
+// Fills 'out[LITE_STATS_ID_<name>]' for every function, summed over all threads so far.
+void lite_stats_snapshot(lite_stats_counters out[LITE_STATS_NFUNCS]);
+
+//--------------------------------------------------------------------------------------------------
+// Internals used by the hooks in 'lite.h'.
+
+typedef struct {
+    lite_stats_counters c;
+} __attribute__((aligned(64))) lite_stats__slot;
+
+typedef struct lite_stats__block lite_stats__block;
+
+struct lite_stats__block {
+    lite_stats__slot slots[LITE_STATS_NFUNCS];
+    // Immutable once the block is published.
+    lite_stats__block *next;
+    // Accessed atomically; non-zero while a thread uses the block.
+    int owned;
+};
+
+extern __thread lite_stats__block *lite_stats__tls;
+
+// Finds or allocates a block for the calling thread and stores it in 'lite_stats__tls'.
+lite_stats__block *lite_stats__attach(void);
+
+typedef struct {
+    lite_stats__slot *slot;
+    uint64_t bytes;
+    uint64_t start;
+} lite_stats__scope;
+
+static inline __attribute__((unused)) uint64_t lite_stats__now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t x;
+    __asm__ volatile ("mrs %0, cntvct_el0" : "=r" (x));
+    return x;
+#else
+    return 0;
+#endif
+}
+
+static inline __attribute__((unused)) lite_stats__scope lite_stats__enter(size_t id, uint64_t bytes)
+{
+    lite_stats__block *b = lite_stats__tls;
+    if (__builtin_expect(!b, 0)) {
+        b = lite_stats__attach();
+    }
+    return (lite_stats__scope) {.slot = &b->slots[id], .bytes = bytes, .start = lite_stats__now()};
+}
+
+// Only the owning thread writes to a slot, so plain (but untorn) loads and stores suffice.
+static inline __attribute__((unused)) void lite_stats__add(uint64_t *counter, uint64_t x)
+{
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + x, __ATOMIC_RELAXED);
+}
+
+static inline __attribute__((unused)) void lite_stats__leave(lite_stats__scope *s)
+{
+    uint64_t end = lite_stats__now();
+    lite_stats_counters *c = &s->slot->c;
+    lite_stats__add(&c->calls, 1);
+    lite_stats__add(&c->bytes, s->bytes);
+    lite_stats__add(&c->cycles, end - s->start);
+}
+
+#ifdef LITE_STATS_USDT
+# if __has_include(<sys/sdt.h>)
+#  include <sys/sdt.h>
+# else
+#  error "LITE_STATS_USDT requires <sys/sdt.h> (e.g. from systemtap-sdt-dev)"
+# endif
+# define LITE_STATS__PROBE(Fn_, Nbytes_) DTRACE_PROBE1(liblite, Fn_, (Nbytes_))
+#else
+# define LITE_STATS__PROBE(Fn_, Nbytes_) ((void) 0)
+#endif
+
+// Placed at the top of an instrumented function; the counters are updated when it returns.
+#define LITE_STATS_SCOPE(Fn_, Nbytes_) \
+    __attribute__((cleanup(lite_stats__leave))) lite_stats__scope lite_stats__s = \
+        lite_stats__enter(LITE_STATS_ID_##Fn_, (Nbytes_)); \
+    LITE_STATS__PROBE(Fn_, Nbytes_)
+
+// Sets the byte count of the current call, for functions where it is only known at the end.
+#define LITE_STATS_BYTES(Nbytes_) (lite_stats__s.bytes = (Nbytes_))
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2021  liblite developers
+ *
+ * This file is part of liblite.
+ *
+ * liblite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liblite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with liblite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "lite.h"
+
+// Searching for a needle in a stream that arrives in chunks of arbitrary size, without copying the
+// chunks into a contiguous buffer.
+//
+// The state carried between chunks is the position in a Knuth-Morris-Pratt automaton (the number
+// of needle bytes matched so far), so a match that straddles chunk boundaries is found, and no byte
+// is looked at twice. The caller supplies the automaton's table: 'fail' must have room for
+// 'nneedle' elements. The needle must not be empty, and must stay alive while the stream is used.
+
+typedef struct {
+    const unsigned char *needle;
+    size_t nneedle;
+    size_t *fail;
+    size_t matched;
+    // The absolute offset of the next byte to be consumed.
+    uint64_t offset;
+} lite_stream;
+
+LITE_INHEADER void lite_stream_init(lite_stream *st, const void *needle, size_t nneedle, size_t *fail)
+{
+    const unsigned char *n = needle;
+    st->needle = n;
+    st->nneedle = nneedle;
+    st->fail = fail;
+    st->matched = 0;
+    st->offset = 0;
+
+    // 'fail[j]' is the length of the longest proper border of 'needle[0..j]'.
+    fail[0] = 0;
+    size_t k = 0;
+    for (size_t j = 1; j < nneedle; ++j) {
+        while (k && n[j] != n[k]) {
+            k = fail[k - 1];
+        }
+        if (n[j] == n[k]) {
+            ++k;
+        }
+        fail[j] = k;
+        LITE_COMPILER_BARRIER();
+    }
+}
+
+// Forgets any partial match and restarts offsets from zero.
+LITE_INHEADER void lite_stream_reset(lite_stream *st)
+{
+    st->matched = 0;
+    st->offset = 0;
+}
+
+// Consumes 'chunk[0..n)' up to and including the last byte of the first match that ends in it.
+//
+// If there is such a match, sets '*pos' to the absolute offset of its first byte (which may be in
+// an earlier chunk) and returns true; the rest of the chunk, starting at 'chunk + *nconsumed',
+// should then be passed again to look for further (possibly overlapping) matches. Otherwise,
+// consumes the whole chunk and returns false.
+LITE_INHEADER bool lite_stream_memmem(
+        lite_stream *st, const void *chunk, size_t n,
+        size_t *nconsumed, uint64_t *pos)
+{
+    const unsigned char *c = chunk;
+    const unsigned char *needle = st->needle;
+    size_t m = st->nneedle;
+    size_t k = st->matched;
+    for (size_t i = 0; i < n; ++i) {
+        while (k && c[i] != needle[k]) {
+            k = st->fail[k - 1];
+        }
+        if (c[i] == needle[k]) {
+            ++k;
+        }
+        if (k == m) {
+            st->matched = st->fail[m - 1];
+            st->offset += i + 1;
+            *nconsumed = i + 1;
+            *pos = st->offset - m;
+            return true;
+        }
+        LITE_COMPILER_BARRIER();
+    }
+    st->matched = k;
+    st->offset += n;
+    *nconsumed = n;
+    return false;
+}
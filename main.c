@@ -18,10 +18,19 @@
  */
 
 #include "lite.h"
+#include "lite_intern.h"
+#include "lite_sso.h"
+#include "lite_multimatch.h"
+#include "lite_stream.h"
+#include "lite_par.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#ifdef LITE_STATS
+# include <pthread.h>
+#endif
 
 #define CALL_TEST(Expr_) \
     do { \
@@ -185,6 +194,136 @@ static void test_lite_memset_null(void)
     CHECK(ret == NULL);
 }
 
+static void test_lite_memcpy_aligned(void)
+{
+    _Alignas(16) char src[40] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    for (size_t n = 0; n <= 36; ++n) {
+        _Alignas(16) char dst8[40];
+        _Alignas(16) char dst16[40];
+        lite_memset(dst8, '~', sizeof(dst8));
+        lite_memset(dst16, '~', sizeof(dst16));
+        CHECK(lite_memcpy_aligned8(dst8, src, n) == dst8);
+        CHECK(lite_memcpy_aligned16(dst16, src, n) == dst16);
+        CHECK(memcmp(dst8, src, n) == 0);
+        CHECK(memcmp(dst16, src, n) == 0);
+        CHECK(dst8[n] == '~');
+        CHECK(dst16[n] == '~');
+    }
+}
+
+static void test_lite_memset_aligned(void)
+{
+    // Larger than needed: at -O3, GCC unrolls the loop over 'n' and warns about 16-byte stores
+    // it wrongly thinks can run past a tighter buffer.
+    for (size_t n = 0; n <= 36; ++n) {
+        _Alignas(16) char buf8[64];
+        _Alignas(16) char buf16[64];
+        char expected[64];
+        lite_memset(buf8, '~', sizeof(buf8));
+        lite_memset(buf16, '~', sizeof(buf16));
+        lite_memset(expected, '~', sizeof(expected));
+        lite_memset(expected, '\xab', n);
+        CHECK(lite_memset_aligned8(buf8, '\xab', n) == buf8);
+        CHECK(lite_memset_aligned16(buf16, '\xab', n) == buf16);
+        CHECK(memcmp(buf8, expected, sizeof(expected)) == 0);
+        CHECK(memcmp(buf16, expected, sizeof(expected)) == 0);
+    }
+}
+
+static void test_lite_memset16(void)
+{
+    uint16_t buf[7] = {0};
+    void *ret = lite_memset16(buf + 1, 0xBEEF, 5);
+    CHECK(ret == buf + 1);
+    CHECK(buf[0] == 0 && buf[6] == 0);
+    for (size_t i = 1; i < 6; ++i) {
+        CHECK(buf[i] == 0xBEEF);
+    }
+}
+
+static void test_lite_memset32(void)
+{
+    uint32_t buf[7] = {0};
+    void *ret = lite_memset32(buf + 1, 0xDEADBEEF, 5);
+    CHECK(ret == buf + 1);
+    CHECK(buf[0] == 0 && buf[6] == 0);
+    for (size_t i = 1; i < 6; ++i) {
+        CHECK(buf[i] == 0xDEADBEEF);
+    }
+}
+
+static void test_lite_memset64(void)
+{
+    uint64_t buf[5] = {0};
+    void *ret = lite_memset64(buf + 1, UINT64_MAX - 1, 3);
+    CHECK(ret == buf + 1);
+    CHECK(buf[0] == 0 && buf[4] == 0);
+    for (size_t i = 1; i < 4; ++i) {
+        CHECK(buf[i] == UINT64_MAX - 1);
+    }
+}
+
+static void test_lite_memset_pattern(const char *pat, size_t n, const char *expected)
+{
+    char buf[64];
+    lite_memset(buf, '~', sizeof(buf));
+    void *ret = lite_memset_pattern(buf + 1, pat, lite_strlen(pat), n);
+    CHECK(ret == buf + 1);
+    CHECK(buf[0] == '~');
+    CHECK(memcmp(buf + 1, expected, n) == 0);
+    CHECK(buf[n + 1] == '~');
+}
+
+static void test_lite_byteset(void)
+{
+    lite_byteset set;
+    lite_byteset_init(&set, " \t\xff");
+    CHECK(lite_byteset_has(&set, ' '));
+    CHECK(lite_byteset_has(&set, '\t'));
+    CHECK(lite_byteset_has(&set, '\xff'));
+    CHECK(!lite_byteset_has(&set, '\0'));
+    CHECK(!lite_byteset_has(&set, 'a'));
+    lite_byteset_add(&set, '\0');
+    CHECK(lite_byteset_has(&set, '\0'));
+}
+
+static void test_lite_strcpy_measure(const char *src, size_t n, size_t expected_len, lite_stop expected_stop)
+{
+    char buf[16];
+    lite_memset(buf, '~', sizeof(buf));
+    lite_copy_result r = lite_strcpy_measure(buf, src, n);
+    CHECK(r.len == expected_len);
+    CHECK(r.end == buf + expected_len);
+    CHECK(r.stop == expected_stop);
+    CHECK(memcmp(buf, src, expected_len) == 0);
+    CHECK(buf[expected_len] == '~');
+}
+
+static void test_lite_memcpy_until(const char *src, const char *stops, size_t expected_len, lite_stop expected_stop)
+{
+    lite_byteset set;
+    lite_byteset_init(&set, stops);
+    size_t n = lite_strlen(src);
+
+    char buf[16];
+    lite_memset(buf, '~', sizeof(buf));
+    lite_copy_result r = lite_memcpy_until(buf, src, n, &set);
+    CHECK(r.len == expected_len);
+    CHECK(r.end == buf + expected_len);
+    CHECK(r.stop == expected_stop);
+    CHECK(memcmp(buf, src, expected_len) == 0);
+    CHECK(buf[expected_len] == '~');
+
+    lite_memset(buf, '~', sizeof(buf));
+    r = lite_memcpy_until_hash(buf, src, n, &set);
+    CHECK(r.len == expected_len);
+    CHECK(r.end == buf + expected_len);
+    CHECK(r.stop == expected_stop);
+    CHECK(r.hash == lite_memhash(src, expected_len));
+    CHECK(memcmp(buf, src, expected_len) == 0);
+    CHECK(buf[expected_len] == '~');
+}
+
 static void test_lite_strcpy(void)
 {
     char buf[] = "foo_bar";
@@ -411,6 +550,76 @@ static void test_lite_strncmp(const char *p, const char *q, size_t n, int expect
     CHECK(ret == expected_ret);
 }
 
+static void test_lite_memcmp_n(const char *p, const char *q, size_t n, int expected_ret)
+{
+    int ret = lite_memcmp(p, q, n);
+    CHECK(ret == expected_ret);
+}
+
+static int ref_strncmp(const char *p, const char *q, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char cp = p[i];
+        unsigned char cq = q[i];
+        if (cp != cq) {
+            return cp < cq ? -1 : 1;
+        }
+        if (cp == '\0') {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+static int ref_memcmp(const char *p, const char *q, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char cp = p[i];
+        unsigned char cq = q[i];
+        if (cp != cq) {
+            return cp < cq ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// The word-at-a-time comparisons must not read past the end of a page that ends right after the
+// string: strings are placed at the end of pages followed by 'PROT_NONE' ones, at every offset
+// from them, and results are checked against byte-by-byte references.
+static void test_lite_strcmp_page_boundary(void)
+{
+    enum { PAGE = 4096 };
+    char *m = mmap(NULL, 4 * PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(m != MAP_FAILED);
+    CHECK(mprotect(m + PAGE, PAGE, PROT_NONE) == 0);
+    CHECK(mprotect(m + 3 * PAGE, PAGE, PROT_NONE) == 0);
+
+    srand(42);
+    for (int iter = 0; iter < 100000; ++iter) {
+        size_t np = rand() % 40;
+        size_t nq = rand() % 40;
+        char *p = m + PAGE - 1 - np - (rand() % 2 ? 0 : rand() % 16);
+        char *q = m + 3 * PAGE - 1 - nq - (rand() % 2 ? 0 : rand() % 16);
+        for (size_t i = 0; i < np; ++i) {
+            p[i] = rand() % 4 ? 'x' : (char) (1 + rand() % 255);
+        }
+        for (size_t i = 0; i < nq; ++i) {
+            q[i] = i < np && rand() % 8 ? p[i] : 'x';
+        }
+        p[np] = '\0';
+        q[nq] = '\0';
+
+        CHECK(lite_strcmp(p, q) == ref_strncmp(p, q, SIZE_MAX));
+        size_t n = rand() % 48;
+        CHECK(lite_strncmp(p, q, n) == ref_strncmp(p, q, n));
+        CHECK(lite_strncmp(p, q, SIZE_MAX) == ref_strncmp(p, q, SIZE_MAX));
+        size_t nmem = rand() % ((np < nq ? np : nq) + 2);
+        CHECK(lite_memcmp(p, q, nmem) == ref_memcmp(p, q, nmem));
+    }
+
+    CHECK(munmap(m, 4 * PAGE) == 0);
+}
+
 static void test_lite_strchr_found(void)
 {
     char buf[] = "foo_bar";
@@ -486,12 +695,202 @@ static void test_lite_memmem(const char *haystack, const char *needle, int expec
     CHECK(ret == expected_ret);
 }
 
+static void test_lite_memrmem(const char *haystack, const char *needle, int expected_offset)
+{
+    size_t nhaystack = lite_strlen(haystack);
+    size_t nneedle = lite_strlen(needle);
+    const char *expected_ret = (expected_offset < 0 ? NULL : (haystack + expected_offset));
+
+    char *ret = lite_memrmem(haystack, nhaystack, needle, nneedle);
+    CHECK(ret == expected_ret);
+
+    ret = lite_strrstr(haystack, needle);
+    CHECK(ret == expected_ret);
+
+    size_t fail[64];
+    lite_rneedle nd;
+    lite_rneedle_init(&nd, needle, nneedle, fail);
+    ret = lite_rneedle_find(&nd, haystack, nhaystack);
+    CHECK(ret == expected_ret);
+}
+
+static void test_lite_multimatch_all(void)
+{
+    static const char *needles[] = {"he", "she", "his", "hers"};
+    size_t lens[] = {2, 3, 3, 4};
+    uint16_t buf[256];
+    CHECK(lite_multimatch_bufsize(needles, lens, 4) <= 256);
+
+    lite_multimatch mm;
+    CHECK(lite_multimatch_compile(&mm, needles, lens, 4, buf, 256));
+
+    static const char *haystack = "ushers and his hers";
+    static const size_t expected[][2] = {{1, 1}, {2, 0}, {2, 3}, {11, 2}, {15, 0}, {15, 3}};
+    lite_multimatch_iter it;
+    lite_multimatch_iter_init(&it);
+    size_t pos;
+    size_t which;
+    size_t i = 0;
+    while (lite_multimatch_next(&mm, &it, haystack, lite_strlen(haystack), &pos, &which)) {
+        CHECK(i < 6);
+        CHECK(pos == expected[i][0]);
+        CHECK(which == expected[i][1]);
+        ++i;
+    }
+    CHECK(i == 6);
+}
+
+static void test_lite_multimatch_find(const char *haystack, int expected_offset, int expected_which)
+{
+    static const char *needles[] = {"://", ", ", "error", "err", "\xff\x00"};
+    size_t lens[] = {3, 2, 5, 3, 2};
+    uint16_t buf[512];
+    lite_multimatch mm;
+    CHECK(lite_multimatch_compile(&mm, needles, lens, 5, buf, 512));
+
+    size_t which = SIZE_MAX;
+    char *ret = lite_multimatch_find(&mm, haystack, lite_strlen(haystack) + 1, &which);
+    const char *expected_ret = (expected_offset < 0 ? NULL : (haystack + expected_offset));
+    CHECK(ret == expected_ret);
+    if (expected_offset >= 0) {
+        CHECK(which == (size_t) expected_which);
+    }
+}
+
+static void test_lite_multimatch_invalid(void)
+{
+    static const char *needles[] = {"foo", ""};
+    size_t lens[] = {3, 0};
+    uint16_t buf[256];
+    lite_multimatch mm;
+    CHECK(!lite_multimatch_compile(&mm, needles, lens, 2, buf, 256));
+    CHECK(!lite_multimatch_compile(&mm, needles, lens, 1, buf, 4));
+}
+
+static void test_lite_stream_memmem(const char *needle, size_t chunk_size)
+{
+    // Compares against a naive search over the whole haystack; small chunk sizes make matches
+    // straddle chunk boundaries.
+    static const char *haystack = "abababx abababa";
+    size_t nhaystack = lite_strlen(haystack);
+    size_t nneedle = lite_strlen(needle);
+    size_t fail[8];
+    lite_stream st;
+    lite_stream_init(&st, needle, nneedle, fail);
+
+    uint64_t found[8];
+    size_t nfound = 0;
+    for (size_t off = 0; off < nhaystack; off += chunk_size) {
+        size_t n = nhaystack - off < chunk_size ? nhaystack - off : chunk_size;
+        size_t used = 0;
+        while (used < n) {
+            size_t k;
+            uint64_t pos;
+            if (lite_stream_memmem(&st, haystack + off + used, n - used, &k, &pos)) {
+                CHECK(nfound < 8);
+                found[nfound++] = pos;
+            }
+            CHECK(k > 0);
+            used += k;
+        }
+    }
+    CHECK(st.offset == nhaystack);
+
+    size_t nexpected = 0;
+    for (size_t i = 0; i + nneedle <= nhaystack; ++i) {
+        if (lite_memcmp(haystack + i, needle, nneedle) == 0) {
+            CHECK(nexpected < nfound);
+            CHECK(found[nexpected] == i);
+            ++nexpected;
+        }
+    }
+    CHECK(nexpected == nfound);
+}
+
 static void test_lite_strstartswith(const char *s, const char *prefix, bool expected_ret)
 {
     bool ret = lite_strstartswith(s, prefix);
     CHECK(ret == expected_ret);
 }
 
+static void test_lite_memstartswith(const char *s, const char *prefix, bool expected_ret)
+{
+    bool ret = lite_memstartswith(s, lite_strlen(s), prefix, lite_strlen(prefix));
+    CHECK(ret == expected_ret);
+}
+
+static void test_lite_memendswith(const char *s, const char *suffix, bool expected_ret)
+{
+    bool ret = lite_memendswith(s, lite_strlen(s), suffix, lite_strlen(suffix));
+    CHECK(ret == expected_ret);
+}
+
+static void test_lite_memcmp_len(const char *p, const char *q, int expected_ret)
+{
+    int ret = lite_memcmp_len(p, lite_strlen(p), q, lite_strlen(q));
+    CHECK(ret == expected_ret);
+    ret = lite_memcmp_len(q, lite_strlen(q), p, lite_strlen(p));
+    CHECK(ret == -expected_ret);
+}
+
+static void test_lite_memxlat(void)
+{
+    unsigned char table[256];
+    for (int i = 0; i < 256; ++i) {
+        table[i] = i;
+    }
+    table['-'] = '_';
+    table['/'] = '.';
+
+    char buf[32];
+    lite_memset(buf, '#', sizeof(buf));
+    CHECK(lite_memxlat(buf, "a-b/c--d", table, 8) == buf);
+    CHECK(lite_memcmp(buf, "a_b.c__d#", 9) == 0);
+
+    char inplace[] = "x-y-z/\xff-";
+    CHECK(lite_memxlat(inplace, inplace, table, 8) == inplace);
+    CHECK(lite_strcmp(inplace, "x_y_z.\xff_") == 0);
+}
+
+static void test_lite_ascii_tolower_mem(const char *s, const char *expected)
+{
+    size_t n = lite_strlen(s);
+    char buf[64];
+    lite_memset(buf, '#', sizeof(buf));
+    CHECK(lite_ascii_tolower_mem(buf, s, n) == buf);
+    CHECK(lite_memcmp(buf, expected, n) == 0);
+    CHECK(buf[n] == '#');
+
+    lite_memcpy(buf, s, n);
+    lite_ascii_tolower_mem(buf, buf, n);
+    CHECK(lite_memcmp(buf, expected, n) == 0);
+}
+
+static void test_lite_ascii_toupper_mem(const char *s, const char *expected)
+{
+    size_t n = lite_strlen(s);
+    char buf[64];
+    lite_memset(buf, '#', sizeof(buf));
+    CHECK(lite_ascii_toupper_mem(buf, s, n) == buf);
+    CHECK(lite_memcmp(buf, expected, n) == 0);
+    CHECK(buf[n] == '#');
+
+    lite_memcpy(buf, s, n);
+    lite_ascii_toupper_mem(buf, buf, n);
+    CHECK(lite_memcmp(buf, expected, n) == 0);
+}
+
+static void test_lite_memrev(const char *s, const char *expected)
+{
+    size_t n = lite_strlen(s);
+    char buf[64];
+    lite_memset(buf, '#', sizeof(buf));
+    lite_memcpy(buf, s, n);
+    CHECK(lite_memrev(buf, n) == buf);
+    CHECK(lite_memcmp(buf, expected, n) == 0);
+    CHECK(buf[n] == '#');
+}
+
 static void test_lite_strtok_r_simple(void)
 {
     char buf[] = "~~one     two three~four ~ five  ~~ ";
@@ -505,8 +904,310 @@ static void test_lite_strtok_r_simple(void)
     CHECK(expected_tokens[i] == NULL);
 }
 
+static const char *batch_strs[] = {
+    "", "a", "foo", "foobar", "calculate the length of the string", "x", "", "haystack", "y", "uwu", "zoo",
+};
+#define NBATCH_STRS (sizeof(batch_strs) / sizeof(batch_strs[0]))
+
+static void test_lite_strlen_batch(void)
+{
+    size_t lens[NBATCH_STRS];
+    lite_strlen_batch(batch_strs, lens, NBATCH_STRS);
+    for (size_t i = 0; i < NBATCH_STRS; ++i) {
+        CHECK(lens[i] == strlen(batch_strs[i]));
+    }
+}
+
+static void test_lite_memeq_batch(void)
+{
+    static const char *other[NBATCH_STRS] = {
+        "", "b", "foo", "foobaz", "calculate the length of the strong", "x", "", "haystick", "y", "uwu", "zoo",
+    };
+    size_t lens[NBATCH_STRS];
+    bool out[NBATCH_STRS];
+    lite_strlen_batch(batch_strs, lens, NBATCH_STRS);
+    lite_memeq_batch((const void *const *) batch_strs, (const void *const *) other, lens, out, NBATCH_STRS);
+    for (size_t i = 0; i < NBATCH_STRS; ++i) {
+        CHECK(out[i] == (memcmp(batch_strs[i], other[i], lens[i]) == 0));
+    }
+}
+
+static void test_lite_strcmp_batch(void)
+{
+    static const char *other[NBATCH_STRS] = {
+        "", "", "bar", "foo", "calculate the length of the strong", "y", "x", "haystack", "y", "zoo", "uwu",
+    };
+    int out[NBATCH_STRS];
+    lite_strcmp_batch(batch_strs, other, out, NBATCH_STRS);
+    for (size_t i = 0; i < NBATCH_STRS; ++i) {
+        int expected = strcmp(batch_strs[i], other[i]);
+        CHECK(out[i] == (expected > 0) - (expected < 0));
+    }
+}
+
+static void test_lite_strsort(void)
+{
+    static const char *strs[] = {
+        "pear", "apple", "applesauce", "applesauces", "", "apples", "banana", "b", "applesaucf",
+        "zoo", "uwu", "apple", "foo", "foobar", "foo", "fo", "applesauce!", "a", "zz", "appl",
+    };
+    enum { N = sizeof(strs) / sizeof(strs[0]) };
+    lite_strentry a[N];
+    for (size_t i = 0; i < N; ++i) {
+        lite_strentry_init(&a[i], strs[i], lite_strlen(strs[i]));
+    }
+    lite_strsort(a, N);
+    for (size_t i = 1; i < N; ++i) {
+        CHECK(strcmp(a[i - 1].str, a[i].str) <= 0);
+        CHECK(lite_strentry_cmp(&a[i - 1], &a[i]) <= 0);
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        lite_strentry *e = lite_strbsearch(a, N, strs[i], lite_strlen(strs[i]));
+        CHECK(e != NULL);
+        CHECK(strcmp(e->str, strs[i]) == 0);
+    }
+    CHECK(lite_strbsearch(a, N, "applesauc", 9) == NULL);
+    CHECK(lite_strbsearch(a, N, "zzz", 3) == NULL);
+    CHECK(lite_strbsearch(a, 0, "foo", 3) == NULL);
+}
+
+static void test_lite_u64toa(uint64_t v, const char *expected)
+{
+    char buf[LITE_U64TOA_BUFSIZE];
+    char *ret = lite_u64toa(buf, v);
+    CHECK(strcmp(buf, expected) == 0);
+    CHECK(ret == buf + strlen(expected));
+}
+
+static void test_lite_u32toa(uint32_t v, const char *expected)
+{
+    char buf[LITE_U32TOA_BUFSIZE];
+    char *ret = lite_u32toa(buf, v);
+    CHECK(strcmp(buf, expected) == 0);
+    CHECK(ret == buf + strlen(expected));
+}
+
+static void test_lite_i64toa(int64_t v, const char *expected)
+{
+    char buf[LITE_I64TOA_BUFSIZE];
+    char *ret = lite_i64toa(buf, v);
+    CHECK(strcmp(buf, expected) == 0);
+    CHECK(ret == buf + strlen(expected));
+}
+
+static void test_lite_parse_u64(const char *s, int expected_offset, uint64_t expected_value)
+{
+    uint64_t value = 42;
+    char *ret = lite_parse_u64(s, lite_strlen(s), &value);
+    if (expected_offset < 0) {
+        CHECK(ret == NULL);
+        CHECK(value == 42);
+    } else {
+        CHECK(ret == s + expected_offset);
+        CHECK(value == expected_value);
+    }
+}
+
+static void test_lite_utf8_valid(const char *s, bool expected_ret)
+{
+    bool ret = lite_utf8_valid(s, lite_strlen(s));
+    CHECK(ret == expected_ret);
+}
+
+static void test_lite_utf8_strlen(const char *s, size_t expected_ret)
+{
+    size_t ret = lite_utf8_strlen(s, lite_strlen(s));
+    CHECK(ret == expected_ret);
+}
+
+static void test_lite_utf8_prefix_trunc(const char *s, size_t max, size_t expected_ret)
+{
+    size_t ret = lite_utf8_prefix_trunc(s, lite_strlen(s), max);
+    CHECK(ret == expected_ret);
+}
+
+static void test_lite_par(size_t nthreads)
+{
+    size_t n = 3 * LITE_PAR_MIN + 17;
+    char *buf = malloc(n);
+    CHECK(buf != NULL);
+    lite_memset(buf, 'a', n);
+    lite_par_pool *pool = lite_par_pool_new(nthreads);
+    CHECK(pool != NULL);
+
+    CHECK(lite_par_memchr(pool, buf, 'b', n) == NULL);
+    CHECK(lite_par_memmem(pool, buf, n, "ab", 2) == NULL);
+
+    // Straddles the boundary between the first two chunks.
+    lite_memcpy(buf + LITE_PAR_CHUNK - 2, "needle", 6);
+    lite_memcpy(buf + 2 * LITE_PAR_MIN, "needle", 6);
+    lite_memcpy(buf + n - 6, "needle", 6);
+    CHECK(lite_par_memmem(pool, buf, n, "needle", 6) == buf + LITE_PAR_CHUNK - 2);
+    CHECK(lite_par_memchr(pool, buf, 'e', n) == buf + LITE_PAR_CHUNK - 1);
+    CHECK(lite_par_memmem(pool, buf + LITE_PAR_CHUNK, n - LITE_PAR_CHUNK, "needle", 6) == buf + 2 * LITE_PAR_MIN);
+    CHECK(lite_par_memmem(pool, buf + 2 * LITE_PAR_MIN + 1, n - 2 * LITE_PAR_MIN - 1, "needle", 6) == buf + n - 6);
+    CHECK(lite_par_memmem(pool, buf, n, "needles", 7) == NULL);
+    CHECK(lite_par_memmem(pool, buf, n, "", 0) == buf);
+
+    // Short inputs are searched by the calling thread.
+    CHECK(lite_par_memmem(pool, "haystack", 8, "stack", 5) != NULL);
+    CHECK(lite_par_memchr(pool, "haystack", 'k', 8) != NULL);
+
+    lite_par_pool_free(pool);
+    free(buf);
+}
+
+static void test_lite_intern_simple(void)
+{
+    lite_intern_slot slots[16];
+    char arena[64];
+    lite_intern t;
+    lite_intern_init(&t, slots, 16, arena, sizeof(arena));
+
+    uint32_t foo = lite_intern_add(&t, "foo", 3);
+    uint32_t bar = lite_intern_add(&t, "bar", 3);
+    uint32_t empty = lite_intern_add(&t, "", 0);
+    CHECK(foo != LITE_INTERN_NONE);
+    CHECK(bar != LITE_INTERN_NONE);
+    CHECK(empty != LITE_INTERN_NONE);
+    CHECK(foo != bar && foo != empty && bar != empty);
+
+    CHECK(lite_intern_add(&t, "foobar", 3) == foo);
+    CHECK(lite_intern_find(&t, "bar", 3) == bar);
+    CHECK(lite_intern_find(&t, "", 0) == empty);
+    CHECK(lite_intern_find(&t, "fo", 2) == LITE_INTERN_NONE);
+    CHECK(lite_intern_find(&t, "quiz", 4) == LITE_INTERN_NONE);
+
+    CHECK(strcmp(lite_intern_str(&t, foo), "foo") == 0);
+    CHECK(strcmp(lite_intern_str(&t, bar), "bar") == 0);
+    CHECK(strcmp(lite_intern_str(&t, empty), "") == 0);
+}
+
+static void test_lite_intern_full(void)
+{
+    lite_intern_slot slots[4];
+    char arena[64];
+    lite_intern t;
+    lite_intern_init(&t, slots, 4, arena, sizeof(arena));
+
+    CHECK(lite_intern_add(&t, "a", 1) != LITE_INTERN_NONE);
+    CHECK(lite_intern_add(&t, "b", 1) != LITE_INTERN_NONE);
+    CHECK(lite_intern_add(&t, "c", 1) != LITE_INTERN_NONE);
+    CHECK(lite_intern_add(&t, "d", 1) == LITE_INTERN_NONE);
+    CHECK(lite_intern_add(&t, "b", 1) != LITE_INTERN_NONE);
+
+    lite_intern_init(&t, slots, 4, arena, 6);
+    CHECK(lite_intern_add(&t, "ab", 2) != LITE_INTERN_NONE);
+    CHECK(lite_intern_add(&t, "cde", 3) == LITE_INTERN_NONE);
+    CHECK(lite_intern_add(&t, "cd", 2) != LITE_INTERN_NONE);
+}
+
+static void test_lite_intern_frozen(void)
+{
+    lite_intern_slot slots[8];
+    char arena[64];
+    lite_intern t;
+    lite_intern_init(&t, slots, 8, arena, sizeof(arena));
+
+    uint32_t foo = lite_intern_add(&t, "foo", 3);
+    lite_intern_freeze(&t);
+    CHECK(lite_intern_add(&t, "foo", 3) == foo);
+    CHECK(lite_intern_add(&t, "bar", 3) == LITE_INTERN_NONE);
+    CHECK(lite_intern_find(&t, "bar", 3) == LITE_INTERN_NONE);
+}
+
+static void test_lite_sso_inline(void)
+{
+    lite_sso s;
+    CHECK(lite_sso_set(&s, "foo", 3, NULL));
+    CHECK(lite_sso_is_inline(&s));
+    CHECK(lite_sso_len(&s) == 3);
+    CHECK(memcmp(lite_sso_data(&s), "foo", 3) == 0);
+
+    CHECK(lite_sso_set(&s, "fifteen_chars!!", 15, NULL));
+    CHECK(lite_sso_is_inline(&s));
+    CHECK(lite_sso_len(&s) == 15);
+    CHECK(memcmp(lite_sso_data(&s), "fifteen_chars!!", 15) == 0);
+
+    CHECK(!lite_sso_set(&s, "sixteen_chars!!!", 16, NULL));
+}
+
+static void test_lite_sso_spilled(void)
+{
+    char buf[20];
+    lite_arena a;
+    lite_arena_init(&a, buf, sizeof(buf));
+
+    lite_sso s;
+    CHECK(lite_sso_set(&s, "sixteen_chars!!!", 16, &a));
+    CHECK(!lite_sso_is_inline(&s));
+    CHECK(lite_sso_len(&s) == 16);
+    CHECK(lite_sso_data(&s) == buf);
+    CHECK(memcmp(buf, "sixteen_chars!!!", 16) == 0);
+
+    CHECK(!lite_sso_set(&s, "sixteen_chars!!!", 16, &a));
+}
+
+static void test_lite_sso_cmp(const char *p, size_t np, const char *q, size_t nq, int expected_ret)
+{
+    char buf[128];
+    lite_arena a;
+    lite_arena_init(&a, buf, sizeof(buf));
+
+    lite_sso sp;
+    lite_sso sq;
+    CHECK(lite_sso_set(&sp, p, np, &a));
+    CHECK(lite_sso_set(&sq, q, nq, &a));
+    CHECK(lite_sso_cmp(&sp, &sq) == expected_ret);
+    CHECK(lite_sso_cmp(&sq, &sp) == -expected_ret);
+    CHECK(lite_sso_eq(&sp, &sq) == (expected_ret == 0));
+    if (expected_ret == 0) {
+        CHECK(lite_sso_hash(&sp) == lite_sso_hash(&sq));
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 
+#ifdef LITE_STATS
+static void *lite_stats_thread(void *arg)
+{
+    (void) arg;
+    char buf[8];
+    lite_memset(buf, 'x', sizeof(buf));
+    return NULL;
+}
+
+static void test_lite_stats(void)
+{
+    lite_stats_counters before[LITE_STATS_NFUNCS];
+    lite_stats_counters after[LITE_STATS_NFUNCS];
+    CHECK(lite_strcmp(lite_stats_name(LITE_STATS_ID_memmem), "memmem") == 0);
+    CHECK(lite_stats_name(LITE_STATS_NFUNCS) == NULL);
+
+    lite_stats_snapshot(before);
+    volatile size_t n = 0;
+    for (int i = 0; i < 3; ++i) {
+        n += lite_strlen("hello");
+    }
+    CHECK(lite_strcmp("abc", "abd") < 0);
+    // Counted after it has exited: its block outlives it.
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, lite_stats_thread, NULL) == 0);
+    CHECK(pthread_join(thread, NULL) == 0);
+    lite_stats_snapshot(after);
+
+    CHECK(n == 15);
+    CHECK(after[LITE_STATS_ID_strlen].calls - before[LITE_STATS_ID_strlen].calls == 3);
+    CHECK(after[LITE_STATS_ID_strlen].bytes - before[LITE_STATS_ID_strlen].bytes == 15);
+    CHECK(after[LITE_STATS_ID_strcmp].calls - before[LITE_STATS_ID_strcmp].calls == 1);
+    CHECK(after[LITE_STATS_ID_strcmp].bytes - before[LITE_STATS_ID_strcmp].bytes == 3);
+    CHECK(after[LITE_STATS_ID_memset].calls - before[LITE_STATS_ID_memset].calls == 1);
+    CHECK(after[LITE_STATS_ID_memset].bytes - before[LITE_STATS_ID_memset].bytes == 8);
+    CHECK(after[LITE_STATS_ID_memchr].calls == before[LITE_STATS_ID_memchr].calls);
+}
+#endif
+
 int main()
 {
     CALL_TEST(test_lite_memcpy_simple());
@@ -532,6 +1233,40 @@ int main()
     CALL_TEST(test_lite_memset_size0());
     CALL_TEST(test_lite_memset_null());
 
+    CALL_TEST(test_lite_memcpy_aligned());
+    CALL_TEST(test_lite_memset_aligned());
+
+    CALL_TEST(test_lite_memset16());
+    CALL_TEST(test_lite_memset32());
+    CALL_TEST(test_lite_memset64());
+
+    CALL_TEST(test_lite_memset_pattern("ab", 0, ""));
+    CALL_TEST(test_lite_memset_pattern("ab", 1, "a"));
+    CALL_TEST(test_lite_memset_pattern("ab", 7, "abababa"));
+    CALL_TEST(test_lite_memset_pattern("abc", 20, "abcabcabcabcabcabcab"));
+    CALL_TEST(test_lite_memset_pattern("0123456789ab", 30, "0123456789ab0123456789ab012345"));
+    CALL_TEST(test_lite_memset_pattern("0123456789ab", 5, "01234"));
+    CALL_TEST(test_lite_memset_pattern("0123456789abcdefg", 10, "0123456789"));
+    CALL_TEST(test_lite_memset_pattern("0123456789abcdefg", 17, "0123456789abcdefg"));
+    CALL_TEST(test_lite_memset_pattern("0123456789abcdefg", 34, "0123456789abcdefg0123456789abcdefg"));
+    CALL_TEST(test_lite_memset_pattern("0123456789abcdefg", 40, "0123456789abcdefg0123456789abcdefg012345"));
+    CALL_TEST(test_lite_memset_pattern("ABCDEFGHIJKLMNOPQRSTUVWXY", 62, "ABCDEFGHIJKLMNOPQRSTUVWXYABCDEFGHIJKLMNOPQRSTUVWXYABCDEFGHIJKL"));
+    CALL_TEST(test_lite_memset_pattern("", 5, "~~~~~"));
+
+    CALL_TEST(test_lite_byteset());
+
+    CALL_TEST(test_lite_strcpy_measure("", 10, 0, LITE_STOP_NUL));
+    CALL_TEST(test_lite_strcpy_measure("foo", 10, 3, LITE_STOP_NUL));
+    CALL_TEST(test_lite_strcpy_measure("foo", 3, 3, LITE_STOP_LIMIT));
+    CALL_TEST(test_lite_strcpy_measure("foobar", 4, 4, LITE_STOP_LIMIT));
+
+    CALL_TEST(test_lite_memcpy_until("key=value", "=", 3, LITE_STOP_BYTE));
+    CALL_TEST(test_lite_memcpy_until("key=value", ";=", 3, LITE_STOP_BYTE));
+    CALL_TEST(test_lite_memcpy_until("=value", "=", 0, LITE_STOP_BYTE));
+    CALL_TEST(test_lite_memcpy_until("key", "=", 3, LITE_STOP_LIMIT));
+    CALL_TEST(test_lite_memcpy_until("key", "", 3, LITE_STOP_LIMIT));
+    CALL_TEST(test_lite_memcpy_until("", "=", 0, LITE_STOP_LIMIT));
+
     CALL_TEST(test_lite_strcpy());
 
     CALL_TEST(test_lite_strncpy_1());
@@ -573,6 +1308,14 @@ int main()
     CALL_TEST(test_lite_memcmp_3());
     CALL_TEST(test_lite_memcmp_size0());
     CALL_TEST(test_lite_memcmp_size0_both_null());
+    CALL_TEST(test_lite_memcmp_n("0123456789", "0123456789", 9, 0));
+    CALL_TEST(test_lite_memcmp_n("0123456789", "0123456788", 10, 1));
+    CALL_TEST(test_lite_memcmp_n("0123456789", "1123456789", 10, -1));
+    CALL_TEST(test_lite_memcmp_n("0123456789abcdef", "0123456789abcdeF", 16, 1));
+    CALL_TEST(test_lite_memcmp_n("0123456789abcdefg", "0123456789abcdefh", 17, -1));
+    CALL_TEST(test_lite_memcmp_n("0123456789abcdefg", "0123456789abcdefh", 16, 0));
+    CALL_TEST(test_lite_memcmp_n("0123456789abcdefghijklmn", "0123456789\xff" "bcdefghijklmn", 24, -1));
+    CALL_TEST(test_lite_memcmp_n("0123456789abcdefghijklmn", "0123456789abcdefghijklmN", 24, 1));
 
     CALL_TEST(test_lite_strcmp("", "", 0));
     CALL_TEST(test_lite_strcmp("x", "", 1));
@@ -582,6 +1325,15 @@ int main()
     CALL_TEST(test_lite_strcmp("uwu", "zoo", -1));
     CALL_TEST(test_lite_strcmp("foobar", "foo", 1));
     CALL_TEST(test_lite_strcmp("foo", "foobar", -1));
+    CALL_TEST(test_lite_strcmp("012345678", "012345678", 0));
+    CALL_TEST(test_lite_strcmp("0123456789abcdef", "0123456789abcdef", 0));
+    CALL_TEST(test_lite_strcmp("0123456789abcdef", "0123456789abcdeg", -1));
+    CALL_TEST(test_lite_strcmp("0123456789abcdefX", "0123456789abcdef", 1));
+    CALL_TEST(test_lite_strcmp("0123456789abcdef", "0123456789abcdefX", -1));
+    CALL_TEST(test_lite_strcmp("0123456789\xff", "0123456789a", 1));
+    CALL_TEST(test_lite_strcmp("0123456789abcdefghijklmn", "0123456789abcdefghijklmn", 0));
+    CALL_TEST(test_lite_strcmp("0123456789abcdefghijklmn", "0123456789abcdefghijklmo", -1));
+    CALL_TEST(test_lite_strcmp("0123456789abcdefghijklm", "0123456789abcdefghijklmn", -1));
 
     CALL_TEST(test_lite_strncmp("", "", 0, 0));
     CALL_TEST(test_lite_strncmp("", "", 128, 0));
@@ -608,6 +1360,17 @@ int main()
     CALL_TEST(test_lite_strncmp("foo", "foobar", 3, 0));
     CALL_TEST(test_lite_strncmp("foo", "foobar", 4, -1));
     CALL_TEST(test_lite_strncmp("foo", "foobar", 128, -1));
+    CALL_TEST(test_lite_strncmp("012345678", "012345679", 8, 0));
+    CALL_TEST(test_lite_strncmp("012345678", "012345679", 9, -1));
+    CALL_TEST(test_lite_strncmp("0123456789abcdef", "0123456789abcdeX", 15, 0));
+    CALL_TEST(test_lite_strncmp("0123456789abcdef", "0123456789abcdeX", 16, 1));
+    CALL_TEST(test_lite_strncmp("0123456789abcdefghij", "0123456789abcdefghiJ", 19, 0));
+    CALL_TEST(test_lite_strncmp("0123456789abcdefghij", "0123456789abcdefghiJ", 20, 1));
+    CALL_TEST(test_lite_strncmp("0123456789abcdefghij", "0123456789abcdefghij", 128, 0));
+    CALL_TEST(test_lite_strncmp("0123456789abcdefghijklmn", "0123456789abcdefghijklm", 23, 0));
+    CALL_TEST(test_lite_strncmp("0123456789abcdefghijklmn", "0123456789abcdefghijklm", 24, 1));
+    CALL_TEST(test_lite_strncmp("0123456789abcdefghijklm", "0123456789abcdefghijklmn", SIZE_MAX, -1));
+    CALL_TEST(test_lite_strcmp_page_boundary());
 
     CALL_TEST(test_lite_strchr_found());
     CALL_TEST(test_lite_strchr_notfound());
@@ -663,6 +1426,42 @@ int main()
     CALL_TEST(test_lite_memmem("hay", "", 0));
     CALL_TEST(test_lite_memmem("", "", 0));
 
+    CALL_TEST(test_lite_memrmem("haystack", "hay", 0));
+    CALL_TEST(test_lite_memrmem("haystack", "a", 5));
+    CALL_TEST(test_lite_memrmem("haystack", "stack", 3));
+    CALL_TEST(test_lite_memrmem("haystack", "stack_", -1));
+    CALL_TEST(test_lite_memrmem("haystack", "haystack", 0));
+    CALL_TEST(test_lite_memrmem("haystack", "haystick", -1));
+    CALL_TEST(test_lite_memrmem("hay", "haystack", -1));
+    CALL_TEST(test_lite_memrmem("hay", "", 3));
+    CALL_TEST(test_lite_memrmem("", "", 0));
+    CALL_TEST(test_lite_memrmem("http://a.b/c?d=http://e", "://", 19));
+    CALL_TEST(test_lite_memrmem("a, b, c, d", ", ", 7));
+    CALL_TEST(test_lite_memrmem("abcabcabcabcabcabcabcabc_abc", "abcabcabcabc", 12));
+    CALL_TEST(test_lite_memrmem("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "aaaaaaaaaaaaaaaaaaab", -1));
+    CALL_TEST(test_lite_memrmem("baaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "baaaaaaaaaaaaaaaaaaa", 0));
+    CALL_TEST(test_lite_memrmem("xabaabaabaabaabaabay", "abaabaabaabaa", 4));
+
+    CALL_TEST(test_lite_multimatch_all());
+    CALL_TEST(test_lite_multimatch_find("", -1, 0));
+    CALL_TEST(test_lite_multimatch_find("nothing here", -1, 0));
+    CALL_TEST(test_lite_multimatch_find("http://x, y", 4, 0));
+    CALL_TEST(test_lite_multimatch_find("x, http://y", 1, 1));
+    CALL_TEST(test_lite_multimatch_find("an error", 3, 3));
+    CALL_TEST(test_lite_multimatch_find("an erro", 3, 3));
+    CALL_TEST(test_lite_multimatch_find("eeeerrr", 3, 3));
+    CALL_TEST(test_lite_multimatch_find("bin\xff", 3, 4));
+
+    CALL_TEST(test_lite_multimatch_invalid());
+
+    for (size_t chunk_size = 1; chunk_size <= 16; ++chunk_size) {
+        CALL_TEST(test_lite_stream_memmem("abab", chunk_size));
+        CALL_TEST(test_lite_stream_memmem("aba", chunk_size));
+        CALL_TEST(test_lite_stream_memmem("x a", chunk_size));
+        CALL_TEST(test_lite_stream_memmem("b", chunk_size));
+        CALL_TEST(test_lite_stream_memmem("abc", chunk_size));
+    }
+
     CALL_TEST(test_lite_strstartswith("foo", "bar", false));
     CALL_TEST(test_lite_strstartswith("foo", "foobar", false));
     CALL_TEST(test_lite_strstartswith("foobar", "foo", true));
@@ -671,8 +1470,157 @@ int main()
     CALL_TEST(test_lite_strstartswith("foo", "", true));
     CALL_TEST(test_lite_strstartswith("", "foo", false));
 
+    CALL_TEST(test_lite_memstartswith("foo", "bar", false));
+    CALL_TEST(test_lite_memstartswith("foo", "foobar", false));
+    CALL_TEST(test_lite_memstartswith("foobar", "foo", true));
+    CALL_TEST(test_lite_memstartswith("foobar", "foobar", true));
+    CALL_TEST(test_lite_memstartswith("", "", true));
+    CALL_TEST(test_lite_memstartswith("foo", "", true));
+    CALL_TEST(test_lite_memstartswith("", "foo", false));
+    CALL_TEST(test_lite_memstartswith("Content-Length: 42", "Content-Length:", true));
+    CALL_TEST(test_lite_memstartswith("Content-Length: 42", "Content-Lengtx:", false));
+    CALL_TEST(test_lite_memstartswith("Content-Length: 42", "Dontent-Length:", false));
+
+    CALL_TEST(test_lite_memendswith("foobar", "bar", true));
+    CALL_TEST(test_lite_memendswith("foobar", "baz", false));
+    CALL_TEST(test_lite_memendswith("bar", "foobar", false));
+    CALL_TEST(test_lite_memendswith("", "", true));
+    CALL_TEST(test_lite_memendswith("foo", "", true));
+    CALL_TEST(test_lite_memendswith("index.html.gz", ".html.gz", true));
+    CALL_TEST(test_lite_memendswith("index.html.gz", ".htmL.gz", false));
+    CALL_TEST(test_lite_memendswith("some/long/path/file.tar.gz", "/path/file.tar.gz", true));
+    CALL_TEST(test_lite_memendswith("some/long/path/file.tar.gz", "/Path/file.tar.gz", false));
+
+    CALL_TEST(test_lite_memcmp_len("", "", 0));
+    CALL_TEST(test_lite_memcmp_len("", "a", -1));
+    CALL_TEST(test_lite_memcmp_len("abc", "abd", -1));
+    CALL_TEST(test_lite_memcmp_len("abc", "abc", 0));
+    CALL_TEST(test_lite_memcmp_len("abc", "abcd", -1));
+    CALL_TEST(test_lite_memcmp_len("b", "abcd", 1));
+    CALL_TEST(test_lite_memcmp_len("0123456789abcdef", "0123456789abcdef", 0));
+    CALL_TEST(test_lite_memcmp_len("0123456789abcdef", "0123456789abcdeg", -1));
+    CALL_TEST(test_lite_memcmp_len("0123456789abcdef", "0123456789abcde", 1));
+    CALL_TEST(test_lite_memcmp_len("0123456789", "0123\xff", -1));
+    CALL_TEST(test_lite_memcmp_len("0123456789", "0123\xff" "56789", -1));
+
+    CALL_TEST(test_lite_memxlat());
+
+    CALL_TEST(test_lite_ascii_tolower_mem("", ""));
+    CALL_TEST(test_lite_ascii_tolower_mem("Foo", "foo"));
+    CALL_TEST(test_lite_ascii_tolower_mem("@AZ[`az{", "@az[`az{"));
+    CALL_TEST(test_lite_ascii_tolower_mem("Content-Type: TEXT/HTML", "content-type: text/html"));
+    CALL_TEST(test_lite_ascii_tolower_mem("\xc1\xc9\xda\x81 ABC \xff", "\xc1\xc9\xda\x81 abc \xff"));
+
+    CALL_TEST(test_lite_ascii_toupper_mem("", ""));
+    CALL_TEST(test_lite_ascii_toupper_mem("Foo", "FOO"));
+    CALL_TEST(test_lite_ascii_toupper_mem("@AZ[`az{", "@AZ[`AZ{"));
+    CALL_TEST(test_lite_ascii_toupper_mem("Content-Type: text/html", "CONTENT-TYPE: TEXT/HTML"));
+    CALL_TEST(test_lite_ascii_toupper_mem("\xe1\xe9\xfa\xa1 abc \xff", "\xe1\xe9\xfa\xa1 ABC \xff"));
+
+    CALL_TEST(test_lite_memrev("", ""));
+    CALL_TEST(test_lite_memrev("a", "a"));
+    CALL_TEST(test_lite_memrev("ab", "ba"));
+    CALL_TEST(test_lite_memrev("abc", "cba"));
+    CALL_TEST(test_lite_memrev("0123456789abcdef", "fedcba9876543210"));
+    CALL_TEST(test_lite_memrev("0123456789abcdefg", "gfedcba9876543210"));
+    CALL_TEST(test_lite_memrev("www.example.com", "moc.elpmaxe.www"));
+    CALL_TEST(test_lite_memrev("0123456789abcdefghijklmnopqrstuvwxyz", "zyxwvutsrqponmlkjihgfedcba9876543210"));
+
     CALL_TEST(test_lite_strtok_r_simple());
 
+    CALL_TEST(test_lite_strlen_batch());
+    CALL_TEST(test_lite_memeq_batch());
+    CALL_TEST(test_lite_strcmp_batch());
+
+    CALL_TEST(test_lite_strsort());
+
+    CALL_TEST(test_lite_u64toa(0, "0"));
+    CALL_TEST(test_lite_u64toa(7, "7"));
+    CALL_TEST(test_lite_u64toa(10, "10"));
+    CALL_TEST(test_lite_u64toa(99, "99"));
+    CALL_TEST(test_lite_u64toa(100, "100"));
+    CALL_TEST(test_lite_u64toa(12345, "12345"));
+    CALL_TEST(test_lite_u64toa(10000000000000000000u, "10000000000000000000"));
+    CALL_TEST(test_lite_u64toa(UINT64_MAX, "18446744073709551615"));
+
+    CALL_TEST(test_lite_u32toa(0, "0"));
+    CALL_TEST(test_lite_u32toa(1000, "1000"));
+    CALL_TEST(test_lite_u32toa(UINT32_MAX, "4294967295"));
+
+    CALL_TEST(test_lite_i64toa(0, "0"));
+    CALL_TEST(test_lite_i64toa(-1, "-1"));
+    CALL_TEST(test_lite_i64toa(-100, "-100"));
+    CALL_TEST(test_lite_i64toa(INT64_MAX, "9223372036854775807"));
+    CALL_TEST(test_lite_i64toa(INT64_MIN, "-9223372036854775808"));
+
+    CALL_TEST(test_lite_parse_u64("0", 1, 0));
+    CALL_TEST(test_lite_parse_u64("42", 2, 42));
+    CALL_TEST(test_lite_parse_u64("42 ", 2, 42));
+    CALL_TEST(test_lite_parse_u64("12345678", 8, 12345678));
+    CALL_TEST(test_lite_parse_u64("1234567:", 7, 1234567));
+    CALL_TEST(test_lite_parse_u64("123456789012345", 15, 123456789012345u));
+    CALL_TEST(test_lite_parse_u64("18446744073709551615", 20, UINT64_MAX));
+    CALL_TEST(test_lite_parse_u64("000000000000000000000018446744073709551615/", 42, UINT64_MAX));
+    CALL_TEST(test_lite_parse_u64("18446744073709551616", -1, 0));
+    CALL_TEST(test_lite_parse_u64("99999999999999999999", -1, 0));
+    CALL_TEST(test_lite_parse_u64("", -1, 0));
+    CALL_TEST(test_lite_parse_u64("-1", -1, 0));
+
+    CALL_TEST(test_lite_utf8_valid("", true));
+    CALL_TEST(test_lite_utf8_valid("plain ascii, longer than a word", true));
+    CALL_TEST(test_lite_utf8_valid("caf\xc3\xa9", true));
+    CALL_TEST(test_lite_utf8_valid("\xe2\x82\xac and \xf0\x9f\x98\x80 and \xf4\x8f\xbf\xbf", true));
+    CALL_TEST(test_lite_utf8_valid("caf\xc3", false));
+    CALL_TEST(test_lite_utf8_valid("\xa9", false));
+    CALL_TEST(test_lite_utf8_valid("\xc0\xaf", false));
+    CALL_TEST(test_lite_utf8_valid("\xe0\x80\xaf", false));
+    CALL_TEST(test_lite_utf8_valid("\xed\xa0\x80", false));
+    CALL_TEST(test_lite_utf8_valid("\xf4\x90\x80\x80", false));
+    CALL_TEST(test_lite_utf8_valid("\xf5\x80\x80\x80", false));
+    CALL_TEST(test_lite_utf8_valid("\xe2\x82x", false));
+    CALL_TEST(test_lite_utf8_valid("0123456789abcdef\xff", false));
+
+    CALL_TEST(test_lite_utf8_strlen("", 0));
+    CALL_TEST(test_lite_utf8_strlen("caf\xc3\xa9", 4));
+    CALL_TEST(test_lite_utf8_strlen("\xe2\x82\xac and \xf0\x9f\x98\x80 and \xf4\x8f\xbf\xbf", 13));
+    CALL_TEST(test_lite_utf8_strlen("plain ascii, longer than a word", 31));
+
+    CALL_TEST(test_lite_utf8_prefix_trunc("caf\xc3\xa9", 10, 5));
+    CALL_TEST(test_lite_utf8_prefix_trunc("caf\xc3\xa9", 5, 5));
+    CALL_TEST(test_lite_utf8_prefix_trunc("caf\xc3\xa9", 4, 3));
+    CALL_TEST(test_lite_utf8_prefix_trunc("caf\xc3\xa9", 3, 3));
+    CALL_TEST(test_lite_utf8_prefix_trunc("\xf0\x9f\x98\x80", 3, 0));
+    CALL_TEST(test_lite_utf8_prefix_trunc("\xf0\x9f\x98\x80", 0, 0));
+
+    CALL_TEST(test_lite_par(0));
+    CALL_TEST(test_lite_par(1));
+    CALL_TEST(test_lite_par(4));
+
+    CALL_TEST(test_lite_intern_simple());
+    CALL_TEST(test_lite_intern_full());
+    CALL_TEST(test_lite_intern_frozen());
+
+    CALL_TEST(test_lite_sso_inline());
+    CALL_TEST(test_lite_sso_spilled());
+
+    CALL_TEST(test_lite_sso_cmp("", 0, "", 0, 0));
+    CALL_TEST(test_lite_sso_cmp("x", 1, "", 0, 1));
+    CALL_TEST(test_lite_sso_cmp("foo", 3, "bar", 3, 1));
+    CALL_TEST(test_lite_sso_cmp("foo", 3, "foo", 3, 0));
+    CALL_TEST(test_lite_sso_cmp("foo", 3, "foobar", 6, -1));
+    CALL_TEST(test_lite_sso_cmp("foo", 3, "foo\0", 4, -1));
+    CALL_TEST(test_lite_sso_cmp("\xff", 1, "a", 1, 1));
+    CALL_TEST(test_lite_sso_cmp("abcdefgh1", 9, "abcdefgh2", 9, -1));
+    CALL_TEST(test_lite_sso_cmp("fifteen_chars!!", 15, "sixteen_chars!!!", 16, -1));
+    CALL_TEST(test_lite_sso_cmp("sixteen_chars!!!", 16, "sixteen_chars!!!", 16, 0));
+    CALL_TEST(test_lite_sso_cmp("sixteen_chars!!!", 16, "sixteen_chars!!", 15, 1));
+    CALL_TEST(test_lite_sso_cmp("sixteen_chars!!!", 16, "sixteen_chars!!!?", 17, -1));
+    CALL_TEST(test_lite_sso_cmp("sixteen_chars!!!", 16, "sixteen_chars!!?", 16, -1));
+
+#ifdef LITE_STATS
+    CALL_TEST(test_lite_stats());
+#endif
+
     fprintf(stderr, "All tests passed!\n");
 
     return 0;